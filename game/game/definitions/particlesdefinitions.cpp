@@ -4,6 +4,7 @@
 
 #include "graphics/pfx/particlefx.h"
 #include "utils/fileext.h"
+#include "resources.h"
 #include "gothic.h"
 
 using namespace Tempest;
@@ -24,6 +25,7 @@ const ParticleFx* ParticlesDefinitions::get(std::string_view name, bool relaxed)
     name = name.substr(0,name.size()-4);
 
   std::lock_guard<std::recursive_mutex> guard(sync);
+  Resources::PinScope                   pin;
   return implGet(name,relaxed);
   }
 
@@ -31,6 +33,7 @@ const ParticleFx* ParticlesDefinitions::get(const ParticleFx* base, const Visual
   if(base==nullptr || key==nullptr)
     return base;
   std::lock_guard<std::recursive_mutex> guard(sync);
+  Resources::PinScope                   pin;
   return implGet(*base,*key);
   }
 
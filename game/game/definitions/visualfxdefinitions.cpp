@@ -3,6 +3,7 @@
 #include <Tempest/Log>
 
 #include "graphics/visualfx.h"
+#include "resources.h"
 #include "gothic.h"
 
 using namespace Tempest;
@@ -21,6 +22,7 @@ const VisualFx* VisualFxDefinitions::get(std::string_view name) {
   if(it!=vfx.end())
     return it->second.get();
 
+  Resources::PinScope                pin;
   Daedalus::GEngineClasses::CFx_Base def;
   if(!implGet(cname,def))
     return nullptr;
@@ -65,7 +65,7 @@ bool GameScript::GlobalOutput::isFinished() {
   }
 
 GameScript::GameScript(GameSession &owner)
-  :vm(Gothic::inst().loadScriptCode("GOTHIC.DAT")),owner(owner) {
+  :vm(Gothic::inst().loadScriptCode("GOTHIC.DAT")),owner(owner),profiler(vm) {
   Daedalus::registerGothicEngineClasses(vm);
   Gothic::inst().setupVmCommonApi(vm);
   aiDefaultPipe.reset(new GlobalOutput(*this));
@@ -76,230 +76,258 @@ GameScript::~GameScript() {
   vm.clearReferences(Daedalus::IC_Info);
   }
 
+template<class F>
+void GameScript::bindExternal(const char* name, F fn) {
+  const size_t id = getSymbolIndex(name);
+  vm.registerExternalFunction(name,[this,id,fn](Daedalus::DaedalusVM& vm){
+    ScriptProfiler::Scope scope(profiler,id);
+    if(npcRec!=nullptr && !std::binary_search(npcProtoSafe.begin(),npcProtoSafe.end(),id))
+      npcRec->valid = false;
+    fn(vm);
+    });
+  }
+
+template<class F>
+void GameScript::npcApply(Npc& npc, F fn) {
+  fn(npc);
+  if(npcRec==nullptr)
+    return;
+  if(&npc!=npcRecSelf)
+    npcRec->valid = false; else
+    npcRec->apply.emplace_back(fn);
+  }
+
+void GameScript::npcProtoInvalidate() {
+  if(npcRec!=nullptr)
+    npcRec->valid = false;
+  }
+
 void GameScript::initCommon() {
-  vm.registerExternalFunction("hlp_random",          [this](Daedalus::DaedalusVM& vm){ hlp_random(vm);         });
-  vm.registerExternalFunction("hlp_isvalidnpc",      [this](Daedalus::DaedalusVM& vm){ hlp_isvalidnpc(vm);     });
-  vm.registerExternalFunction("hlp_isvaliditem",     [this](Daedalus::DaedalusVM& vm){ hlp_isvaliditem(vm);    });
-  vm.registerExternalFunction("hlp_isitem",          [this](Daedalus::DaedalusVM& vm){ hlp_isitem(vm);         });
-  vm.registerExternalFunction("hlp_getnpc",          [this](Daedalus::DaedalusVM& vm){ hlp_getnpc(vm);         });
-  vm.registerExternalFunction("hlp_getinstanceid",   [this](Daedalus::DaedalusVM& vm){ hlp_getinstanceid(vm);  });
-
-  vm.registerExternalFunction("wld_insertnpc",       [this](Daedalus::DaedalusVM& vm){ wld_insertnpc(vm);  });
-  vm.registerExternalFunction("wld_insertitem",      [this](Daedalus::DaedalusVM& vm){ wld_insertitem(vm); });
-  vm.registerExternalFunction("wld_settime",         [this](Daedalus::DaedalusVM& vm){ wld_settime(vm);    });
-  vm.registerExternalFunction("wld_getday",          [this](Daedalus::DaedalusVM& vm){ wld_getday(vm);     });
-  vm.registerExternalFunction("wld_playeffect",      [this](Daedalus::DaedalusVM& vm){ wld_playeffect(vm); });
-  vm.registerExternalFunction("wld_stopeffect",      [this](Daedalus::DaedalusVM& vm){ wld_stopeffect(vm); });
-  vm.registerExternalFunction("wld_getplayerportalguild",
-                                                     [this](Daedalus::DaedalusVM& vm){ wld_getplayerportalguild(vm); });
-  vm.registerExternalFunction("wld_getformerplayerportalguild",
-                                                     [this](Daedalus::DaedalusVM& vm){ wld_getformerplayerportalguild(vm); });
-  vm.registerExternalFunction("wld_setguildattitude",[this](Daedalus::DaedalusVM& vm){ wld_setguildattitude(vm);     });
-  vm.registerExternalFunction("wld_getguildattitude",[this](Daedalus::DaedalusVM& vm){ wld_getguildattitude(vm);     });
-  vm.registerExternalFunction("wld_istime",          [this](Daedalus::DaedalusVM& vm){ wld_istime(vm);               });
-  vm.registerExternalFunction("wld_isfpavailable",   [this](Daedalus::DaedalusVM& vm){ wld_isfpavailable(vm);        });
-  vm.registerExternalFunction("wld_isnextfpavailable",
-                                                     [this](Daedalus::DaedalusVM& vm){ wld_isnextfpavailable(vm);    });
-  vm.registerExternalFunction("wld_ismobavailable",  [this](Daedalus::DaedalusVM& vm){ wld_ismobavailable(vm);       });
-  vm.registerExternalFunction("wld_setmobroutine",   [this](Daedalus::DaedalusVM& vm){ wld_setmobroutine(vm);        });
-  vm.registerExternalFunction("wld_getmobstate",     [this](Daedalus::DaedalusVM& vm){ wld_getmobstate(vm);          });
-  vm.registerExternalFunction("wld_assignroomtoguild",
-                                                     [this](Daedalus::DaedalusVM& vm){ wld_assignroomtoguild(vm);    });
-  vm.registerExternalFunction("wld_detectnpc",       [this](Daedalus::DaedalusVM& vm){ wld_detectnpc(vm);            });
-  vm.registerExternalFunction("wld_detectnpcex",     [this](Daedalus::DaedalusVM& vm){ wld_detectnpcex(vm);          });
-  vm.registerExternalFunction("wld_detectitem",      [this](Daedalus::DaedalusVM& vm){ wld_detectitem(vm);           });
-  vm.registerExternalFunction("wld_spawnnpcrange",   [this](Daedalus::DaedalusVM& vm){ wld_spawnnpcrange(vm);        });
-  vm.registerExternalFunction("wld_sendtrigger",     [this](Daedalus::DaedalusVM& vm){ wld_sendtrigger(vm);          });
-  vm.registerExternalFunction("wld_senduntrigger",   [this](Daedalus::DaedalusVM& vm){ wld_senduntrigger(vm);        });
-  vm.registerExternalFunction("wld_israining",       [this](Daedalus::DaedalusVM& vm){ wld_israining(vm);            });
-
-  vm.registerExternalFunction("mdl_setvisual",       [this](Daedalus::DaedalusVM& vm){ mdl_setvisual(vm);        });
-  vm.registerExternalFunction("mdl_setvisualbody",   [this](Daedalus::DaedalusVM& vm){ mdl_setvisualbody(vm);    });
-  vm.registerExternalFunction("mdl_setmodelfatness", [this](Daedalus::DaedalusVM& vm){ mdl_setmodelfatness(vm);  });
-  vm.registerExternalFunction("mdl_applyoverlaymds", [this](Daedalus::DaedalusVM& vm){ mdl_applyoverlaymds(vm);  });
-  vm.registerExternalFunction("mdl_applyoverlaymdstimed",
-                                                     [this](Daedalus::DaedalusVM& vm){ mdl_applyoverlaymdstimed(vm); });
-  vm.registerExternalFunction("mdl_removeoverlaymds",[this](Daedalus::DaedalusVM& vm){ mdl_removeoverlaymds(vm); });
-  vm.registerExternalFunction("mdl_setmodelscale",   [this](Daedalus::DaedalusVM& vm){ mdl_setmodelscale(vm);    });
-  vm.registerExternalFunction("mdl_startfaceani",    [this](Daedalus::DaedalusVM& vm){ mdl_startfaceani(vm);     });
-  vm.registerExternalFunction("mdl_applyrandomani",  [this](Daedalus::DaedalusVM& vm){ mdl_applyrandomani(vm);   });
-  vm.registerExternalFunction("mdl_applyrandomanifreq",
-                                                     [this](Daedalus::DaedalusVM& vm){ mdl_applyrandomanifreq(vm);});
-  vm.registerExternalFunction("mdl_applyrandomfaceani",
-                                                     [this](Daedalus::DaedalusVM& vm){ mdl_applyrandomfaceani(vm);});
-
-  vm.registerExternalFunction("npc_settofightmode",  [this](Daedalus::DaedalusVM& vm){ npc_settofightmode(vm);   });
-  vm.registerExternalFunction("npc_settofistmode",   [this](Daedalus::DaedalusVM& vm){ npc_settofistmode(vm);    });
-  vm.registerExternalFunction("npc_isinstate",       [this](Daedalus::DaedalusVM& vm){ npc_isinstate(vm);        });
-  vm.registerExternalFunction("npc_isinroutine",     [this](Daedalus::DaedalusVM& vm){ npc_isinroutine(vm);      });
-  vm.registerExternalFunction("npc_wasinstate",      [this](Daedalus::DaedalusVM& vm){ npc_wasinstate(vm);       });
-  vm.registerExternalFunction("npc_getdisttowp",     [this](Daedalus::DaedalusVM& vm){ npc_getdisttowp(vm);      });
-  vm.registerExternalFunction("npc_exchangeroutine", [this](Daedalus::DaedalusVM& vm){ npc_exchangeroutine(vm);  });
-  vm.registerExternalFunction("npc_isdead",          [this](Daedalus::DaedalusVM& vm){ npc_isdead(vm);           });
-  vm.registerExternalFunction("npc_knowsinfo",       [this](Daedalus::DaedalusVM& vm){ npc_knowsinfo(vm);        });
-  vm.registerExternalFunction("npc_settalentskill",  [this](Daedalus::DaedalusVM& vm){ npc_settalentskill(vm);   });
-  vm.registerExternalFunction("npc_gettalentskill",  [this](Daedalus::DaedalusVM& vm){ npc_gettalentskill(vm);   });
-  vm.registerExternalFunction("npc_settalentvalue",  [this](Daedalus::DaedalusVM& vm){ npc_settalentvalue(vm);   });
-  vm.registerExternalFunction("npc_gettalentvalue",  [this](Daedalus::DaedalusVM& vm){ npc_gettalentvalue(vm);   });
-  vm.registerExternalFunction("npc_setrefusetalk",   [this](Daedalus::DaedalusVM& vm){ npc_setrefusetalk(vm);    });
-  vm.registerExternalFunction("npc_refusetalk",      [this](Daedalus::DaedalusVM& vm){ npc_refusetalk(vm);       });
-  vm.registerExternalFunction("npc_hasitems",        [this](Daedalus::DaedalusVM& vm){ npc_hasitems(vm);         });
-  vm.registerExternalFunction("npc_getinvitem",      [this](Daedalus::DaedalusVM& vm){ npc_getinvitem(vm);       });
-  vm.registerExternalFunction("npc_removeinvitem",   [this](Daedalus::DaedalusVM& vm){ npc_removeinvitem(vm);    });
-  vm.registerExternalFunction("npc_removeinvitems",  [this](Daedalus::DaedalusVM& vm){ npc_removeinvitems(vm);   });
-  vm.registerExternalFunction("npc_getbodystate",    [this](Daedalus::DaedalusVM& vm){ npc_getbodystate(vm);     });
-  vm.registerExternalFunction("npc_getlookattarget", [this](Daedalus::DaedalusVM& vm){ npc_getlookattarget(vm);  });
-  vm.registerExternalFunction("npc_getdisttonpc",    [this](Daedalus::DaedalusVM& vm){ npc_getdisttonpc(vm);     });
-  vm.registerExternalFunction("npc_hasequippedarmor",[this](Daedalus::DaedalusVM& vm){ npc_hasequippedarmor(vm); });
-  vm.registerExternalFunction("npc_setperctime",     [this](Daedalus::DaedalusVM& vm){ npc_setperctime(vm);      });
-  vm.registerExternalFunction("npc_percenable",      [this](Daedalus::DaedalusVM& vm){ npc_percenable(vm);       });
-  vm.registerExternalFunction("npc_percdisable",     [this](Daedalus::DaedalusVM& vm){ npc_percdisable(vm);      });
-  vm.registerExternalFunction("npc_getnearestwp",    [this](Daedalus::DaedalusVM& vm){ npc_getnearestwp(vm);     });
-  vm.registerExternalFunction("npc_clearaiqueue",    [this](Daedalus::DaedalusVM& vm){ npc_clearaiqueue(vm);     });
-  vm.registerExternalFunction("npc_isplayer",        [this](Daedalus::DaedalusVM& vm){ npc_isplayer(vm);         });
-  vm.registerExternalFunction("npc_getstatetime",    [this](Daedalus::DaedalusVM& vm){ npc_getstatetime(vm);     });
-  vm.registerExternalFunction("npc_setstatetime",    [this](Daedalus::DaedalusVM& vm){ npc_setstatetime(vm);     });
-  vm.registerExternalFunction("npc_changeattribute", [this](Daedalus::DaedalusVM& vm){ npc_changeattribute(vm);  });
-  vm.registerExternalFunction("npc_isonfp",          [this](Daedalus::DaedalusVM& vm){ npc_isonfp(vm);           });
-  vm.registerExternalFunction("npc_getheighttonpc",  [this](Daedalus::DaedalusVM& vm){ npc_getheighttonpc(vm);   });
-  vm.registerExternalFunction("npc_getequippedmeleeweapon",
-                                                     [this](Daedalus::DaedalusVM& vm){ npc_getequippedmeleeweapon(vm); });
-  vm.registerExternalFunction("npc_getequippedrangedweapon",
-                                                     [this](Daedalus::DaedalusVM& vm){ npc_getequippedrangedweapon(vm); });
-  vm.registerExternalFunction("npc_getequippedarmor",[this](Daedalus::DaedalusVM& vm){ npc_getequippedarmor(vm); });
-  vm.registerExternalFunction("npc_canseenpc",       [this](Daedalus::DaedalusVM& vm){ npc_canseenpc(vm);        });
-  vm.registerExternalFunction("npc_hasequippedweapon",
-                                                     [this](Daedalus::DaedalusVM& vm){ npc_hasequippedweapon(vm); });
-  vm.registerExternalFunction("npc_hasequippedmeleeweapon",
-                                                     [this](Daedalus::DaedalusVM& vm){ npc_hasequippedmeleeweapon(vm); });
-  vm.registerExternalFunction("npc_hasequippedrangedweapon",
-                                                     [this](Daedalus::DaedalusVM& vm){ npc_hasequippedrangedweapon(vm); });
-  vm.registerExternalFunction("npc_getactivespell",  [this](Daedalus::DaedalusVM& vm){ npc_getactivespell(vm);   });
-  vm.registerExternalFunction("npc_getactivespellisscroll",
-                                                     [this](Daedalus::DaedalusVM& vm){ npc_getactivespellisscroll(vm); });
-  vm.registerExternalFunction("npc_getactivespellcat",
-                                                     [this](Daedalus::DaedalusVM& vm){ npc_getactivespellcat(vm); });
-  vm.registerExternalFunction("npc_setactivespellinfo",
-                                                     [this](Daedalus::DaedalusVM& vm){ npc_setactivespellinfo(vm); });
-  vm.registerExternalFunction("npc_getactivespelllevel",
-                                                     [this](Daedalus::DaedalusVM& vm){ npc_getactivespelllevel(vm); });
-
-  vm.registerExternalFunction("npc_canseenpcfreelos",[this](Daedalus::DaedalusVM& vm){ npc_canseenpcfreelos(vm); });
-  vm.registerExternalFunction("npc_isinfightmode",   [this](Daedalus::DaedalusVM& vm){ npc_isinfightmode(vm);    });
-  vm.registerExternalFunction("npc_settarget",       [this](Daedalus::DaedalusVM& vm){ npc_settarget(vm);        });
-  vm.registerExternalFunction("npc_gettarget",       [this](Daedalus::DaedalusVM& vm){ npc_gettarget(vm);        });
-  vm.registerExternalFunction("npc_getnexttarget",   [this](Daedalus::DaedalusVM& vm){ npc_getnexttarget(vm);    });
-  vm.registerExternalFunction("npc_sendpassiveperc", [this](Daedalus::DaedalusVM& vm){ npc_sendpassiveperc(vm);  });
-  vm.registerExternalFunction("npc_checkinfo",       [this](Daedalus::DaedalusVM& vm){ npc_checkinfo(vm);        });
-  vm.registerExternalFunction("npc_getportalguild",  [this](Daedalus::DaedalusVM& vm){ npc_getportalguild(vm);   });
-  vm.registerExternalFunction("npc_isinplayersroom", [this](Daedalus::DaedalusVM& vm){ npc_isinplayersroom(vm);  });
-  vm.registerExternalFunction("npc_getreadiedweapon",[this](Daedalus::DaedalusVM& vm){ npc_getreadiedweapon(vm); });
-  vm.registerExternalFunction("npc_hasreadiedmeleeweapon",
-                                                     [this](Daedalus::DaedalusVM& vm){ npc_hasreadiedmeleeweapon(vm); });
-  vm.registerExternalFunction("npc_isdrawingspell",  [this](Daedalus::DaedalusVM& vm){ npc_isdrawingspell(vm);   });
-  vm.registerExternalFunction("npc_isdrawingweapon", [this](Daedalus::DaedalusVM& vm){ npc_isdrawingweapon(vm);  });
-  vm.registerExternalFunction("npc_perceiveall",     [this](Daedalus::DaedalusVM& vm){ npc_perceiveall(vm);      });
-  vm.registerExternalFunction("npc_stopani",         [this](Daedalus::DaedalusVM& vm){ npc_stopani(vm);          });
-  vm.registerExternalFunction("npc_settrueguild",    [this](Daedalus::DaedalusVM& vm){ npc_settrueguild(vm);     });
-  vm.registerExternalFunction("npc_gettrueguild",    [this](Daedalus::DaedalusVM& vm){ npc_gettrueguild(vm);     });
-  vm.registerExternalFunction("npc_clearinventory",  [this](Daedalus::DaedalusVM& vm){ npc_clearinventory(vm);   });
-  vm.registerExternalFunction("npc_getattitude",     [this](Daedalus::DaedalusVM& vm){ npc_getattitude(vm);      });
-  vm.registerExternalFunction("npc_getpermattitude", [this](Daedalus::DaedalusVM& vm){ npc_getpermattitude(vm);  });
-  vm.registerExternalFunction("npc_setattitude",     [this](Daedalus::DaedalusVM& vm){ npc_setattitude(vm);      });
-  vm.registerExternalFunction("npc_settempattitude", [this](Daedalus::DaedalusVM& vm){ npc_settempattitude(vm);  });
-  vm.registerExternalFunction("npc_hasbodyflag",     [this](Daedalus::DaedalusVM& vm){ npc_hasbodyflag(vm);      });
-  vm.registerExternalFunction("npc_getlasthitspellid",
-                                                     [this](Daedalus::DaedalusVM& vm){ npc_getlasthitspellid(vm);});
-  vm.registerExternalFunction("npc_getlasthitspellcat",
-                                                     [this](Daedalus::DaedalusVM& vm){ npc_getlasthitspellcat(vm);});
-  vm.registerExternalFunction("npc_playani",         [this](Daedalus::DaedalusVM& vm){ npc_playani(vm);          });
-
-  vm.registerExternalFunction("npc_isdetectedmobownedbynpc",
-                                                     [this](Daedalus::DaedalusVM& vm){ npc_isdetectedmobownedbynpc(vm);});
-  vm.registerExternalFunction("npc_getdetectedmob",  [this](Daedalus::DaedalusVM& vm){ npc_getdetectedmob(vm);   });
-  vm.registerExternalFunction("npc_isdetectedmobownedbyguild",
-                                                     [this](Daedalus::DaedalusVM& vm) { npc_isdetectedmobownedbyguild(vm); });
-  vm.registerExternalFunction("npc_ownedbynpc",      [this](Daedalus::DaedalusVM& vm){ npc_ownedbynpc(vm);       });
-  vm.registerExternalFunction("npc_canseesource",    [this](Daedalus::DaedalusVM& vm){ npc_canseesource(vm);     });
-  vm.registerExternalFunction("npc_getdisttoitem",   [this](Daedalus::DaedalusVM& vm){ npc_getdisttoitem(vm);    });
-  vm.registerExternalFunction("npc_getheighttoitem", [this](Daedalus::DaedalusVM& vm){ npc_getheighttoitem(vm);  });
-  vm.registerExternalFunction("npc_getdisttoplayer", [this](Daedalus::DaedalusVM& vm){ npc_getdisttoplayer(vm);  });
-
-  vm.registerExternalFunction("ai_output",           [this](Daedalus::DaedalusVM& vm){ ai_output(vm);            });
-  vm.registerExternalFunction("ai_stopprocessinfos", [this](Daedalus::DaedalusVM& vm){ ai_stopprocessinfos(vm);  });
-  vm.registerExternalFunction("ai_processinfos",     [this](Daedalus::DaedalusVM& vm){ ai_processinfos(vm);      });
-  vm.registerExternalFunction("ai_standup",          [this](Daedalus::DaedalusVM& vm){ ai_standup(vm);           });
-  vm.registerExternalFunction("ai_standupquick",     [this](Daedalus::DaedalusVM& vm){ ai_standupquick(vm);      });
-  vm.registerExternalFunction("ai_continueroutine",  [this](Daedalus::DaedalusVM& vm){ ai_continueroutine(vm);   });
-  vm.registerExternalFunction("ai_stoplookat",       [this](Daedalus::DaedalusVM& vm){ ai_stoplookat(vm);        });
-  vm.registerExternalFunction("ai_lookatnpc",        [this](Daedalus::DaedalusVM& vm){ ai_lookatnpc(vm);         });
-  vm.registerExternalFunction("ai_removeweapon",     [this](Daedalus::DaedalusVM& vm){ ai_removeweapon(vm);      });
-  vm.registerExternalFunction("ai_turntonpc",        [this](Daedalus::DaedalusVM& vm){ ai_turntonpc(vm);         });
-  vm.registerExternalFunction("ai_outputsvm",        [this](Daedalus::DaedalusVM& vm){ ai_outputsvm(vm);         });
-  vm.registerExternalFunction("ai_outputsvm_overlay",[this](Daedalus::DaedalusVM& vm){ ai_outputsvm_overlay(vm); });
-  vm.registerExternalFunction("ai_startstate",       [this](Daedalus::DaedalusVM& vm){ ai_startstate(vm);        });
-  vm.registerExternalFunction("ai_playani",          [this](Daedalus::DaedalusVM& vm){ ai_playani(vm);           });
-  vm.registerExternalFunction("ai_setwalkmode",      [this](Daedalus::DaedalusVM& vm){ ai_setwalkmode(vm);       });
-  vm.registerExternalFunction("ai_wait",             [this](Daedalus::DaedalusVM& vm){ ai_wait(vm);              });
-  vm.registerExternalFunction("ai_waitms",           [this](Daedalus::DaedalusVM& vm){ ai_waitms(vm);            });
-  vm.registerExternalFunction("ai_aligntowp",        [this](Daedalus::DaedalusVM& vm){ ai_aligntowp(vm);         });
-  vm.registerExternalFunction("ai_gotowp",           [this](Daedalus::DaedalusVM& vm){ ai_gotowp(vm);            });
-  vm.registerExternalFunction("ai_gotofp",           [this](Daedalus::DaedalusVM& vm){ ai_gotofp(vm);            });
-  vm.registerExternalFunction("ai_playanibs",        [this](Daedalus::DaedalusVM& vm){ ai_playanibs(vm);         });
-  vm.registerExternalFunction("ai_equiparmor",       [this](Daedalus::DaedalusVM& vm){ ai_equiparmor(vm);        });
-  vm.registerExternalFunction("ai_equipbestarmor",   [this](Daedalus::DaedalusVM& vm){ ai_equipbestarmor(vm);    });
-  vm.registerExternalFunction("ai_equipbestmeleeweapon",
-                                                     [this](Daedalus::DaedalusVM& vm){ ai_equipbestmeleeweapon(vm);  });
-  vm.registerExternalFunction("ai_equipbestrangedweapon",
-                                                     [this](Daedalus::DaedalusVM& vm){ ai_equipbestrangedweapon(vm); });
-  vm.registerExternalFunction("ai_usemob",           [this](Daedalus::DaedalusVM& vm){ ai_usemob(vm);            });
-  vm.registerExternalFunction("ai_teleport",         [this](Daedalus::DaedalusVM& vm){ ai_teleport(vm);          });
-  vm.registerExternalFunction("ai_stoppointat",      [this](Daedalus::DaedalusVM& vm){ ai_stoppointat(vm);       });
-  vm.registerExternalFunction("ai_drawweapon",       [this](Daedalus::DaedalusVM& vm){ ai_drawweapon(vm);  });
-  vm.registerExternalFunction("ai_readymeleeweapon", [this](Daedalus::DaedalusVM& vm){ ai_readymeleeweapon(vm);  });
-  vm.registerExternalFunction("ai_readyrangedweapon",[this](Daedalus::DaedalusVM& vm){ ai_readyrangedweapon(vm); });
-  vm.registerExternalFunction("ai_readyspell",       [this](Daedalus::DaedalusVM& vm){ ai_readyspell(vm);        });
-  vm.registerExternalFunction("ai_attack",           [this](Daedalus::DaedalusVM& vm){ ai_atack(vm);             });
-  vm.registerExternalFunction("ai_flee",             [this](Daedalus::DaedalusVM& vm){ ai_flee(vm);              });
-  vm.registerExternalFunction("ai_dodge",            [this](Daedalus::DaedalusVM& vm){ ai_dodge(vm);             });
-  vm.registerExternalFunction("ai_unequipweapons",   [this](Daedalus::DaedalusVM& vm){ ai_unequipweapons(vm);    });
-  vm.registerExternalFunction("ai_unequiparmor",     [this](Daedalus::DaedalusVM& vm){ ai_unequiparmor(vm);      });
-  vm.registerExternalFunction("ai_gotonpc",          [this](Daedalus::DaedalusVM& vm){ ai_gotonpc(vm);           });
-  vm.registerExternalFunction("ai_gotonextfp",       [this](Daedalus::DaedalusVM& vm){ ai_gotonextfp(vm);        });
-  vm.registerExternalFunction("ai_aligntofp",        [this](Daedalus::DaedalusVM& vm){ ai_aligntofp(vm);         });
-  vm.registerExternalFunction("ai_useitem",          [this](Daedalus::DaedalusVM& vm){ ai_useitem(vm);           });
-  vm.registerExternalFunction("ai_useitemtostate",   [this](Daedalus::DaedalusVM& vm){ ai_useitemtostate(vm);    });
-  vm.registerExternalFunction("ai_setnpcstostate",   [this](Daedalus::DaedalusVM& vm){ ai_setnpcstostate(vm);    });
-  vm.registerExternalFunction("ai_finishingmove",    [this](Daedalus::DaedalusVM& vm){ ai_finishingmove(vm);     });
-  vm.registerExternalFunction("ai_takeitem",         [this](Daedalus::DaedalusVM& vm){ ai_takeitem(vm);          });
-  vm.registerExternalFunction("ai_gotoitem",         [this](Daedalus::DaedalusVM& vm){ ai_gotoitem(vm);          });
-  vm.registerExternalFunction("ai_pointat",          [this](Daedalus::DaedalusVM& vm){ ai_pointat(vm);           });
-  vm.registerExternalFunction("ai_pointatnpc",       [this](Daedalus::DaedalusVM& vm){ ai_pointatnpc(vm);        });
-
-  vm.registerExternalFunction("mob_hasitems",        [this](Daedalus::DaedalusVM& vm){ mob_hasitems(vm);         });
-
-  vm.registerExternalFunction("ta_min",              [this](Daedalus::DaedalusVM& vm){ ta_min(vm);               });
-
-  vm.registerExternalFunction("log_createtopic",     [this](Daedalus::DaedalusVM& vm){ log_createtopic(vm);      });
-  vm.registerExternalFunction("log_settopicstatus",  [this](Daedalus::DaedalusVM& vm){ log_settopicstatus(vm);   });
-  vm.registerExternalFunction("log_addentry",        [this](Daedalus::DaedalusVM& vm){ log_addentry(vm);         });
-
-  vm.registerExternalFunction("equipitem",           [this](Daedalus::DaedalusVM& vm){ equipitem(vm);            });
-  vm.registerExternalFunction("createinvitem",       [this](Daedalus::DaedalusVM& vm){ createinvitem(vm);        });
-  vm.registerExternalFunction("createinvitems",      [this](Daedalus::DaedalusVM& vm){ createinvitems(vm);       });
-
-  vm.registerExternalFunction("info_addchoice",      [this](Daedalus::DaedalusVM& vm){ info_addchoice(vm);       });
-  vm.registerExternalFunction("info_clearchoices",   [this](Daedalus::DaedalusVM& vm){ info_clearchoices(vm);    });
-  vm.registerExternalFunction("infomanager_hasfinished",
-                                                     [this](Daedalus::DaedalusVM& vm){ infomanager_hasfinished(vm); });
-
-  vm.registerExternalFunction("snd_play",            [this](Daedalus::DaedalusVM& vm){ snd_play(vm);             });
-  vm.registerExternalFunction("snd_play3d",          [this](Daedalus::DaedalusVM& vm){ snd_play3d(vm);           });
-
-  vm.registerExternalFunction("game_initgerman",     [this](Daedalus::DaedalusVM& vm){ game_initgerman(vm);      });
-  vm.registerExternalFunction("game_initenglish",    [this](Daedalus::DaedalusVM& vm){ game_initenglish(vm);     });
-
-  vm.registerExternalFunction("exitsession",         [this](Daedalus::DaedalusVM& vm){ exitsession(vm);          });
+  symIndex.build(vm.getDATFile().getSymTable().symbols);
+
+  bindExternal("hlp_random",          [this](Daedalus::DaedalusVM& vm){ hlp_random(vm);         });
+  bindExternal("hlp_isvalidnpc",      [this](Daedalus::DaedalusVM& vm){ hlp_isvalidnpc(vm);     });
+  bindExternal("hlp_isvaliditem",     [this](Daedalus::DaedalusVM& vm){ hlp_isvaliditem(vm);    });
+  bindExternal("hlp_isitem",          [this](Daedalus::DaedalusVM& vm){ hlp_isitem(vm);         });
+  bindExternal("hlp_getnpc",          [this](Daedalus::DaedalusVM& vm){ hlp_getnpc(vm);         });
+  bindExternal("hlp_getinstanceid",   [this](Daedalus::DaedalusVM& vm){ hlp_getinstanceid(vm);  });
+
+  bindExternal("wld_insertnpc",       [this](Daedalus::DaedalusVM& vm){ wld_insertnpc(vm);  });
+  bindExternal("wld_insertitem",      [this](Daedalus::DaedalusVM& vm){ wld_insertitem(vm); });
+  bindExternal("wld_settime",         [this](Daedalus::DaedalusVM& vm){ wld_settime(vm);    });
+  bindExternal("wld_getday",          [this](Daedalus::DaedalusVM& vm){ wld_getday(vm);     });
+  bindExternal("wld_playeffect",      [this](Daedalus::DaedalusVM& vm){ wld_playeffect(vm); });
+  bindExternal("wld_stopeffect",      [this](Daedalus::DaedalusVM& vm){ wld_stopeffect(vm); });
+  bindExternal("wld_getplayerportalguild",
+                                      [this](Daedalus::DaedalusVM& vm){ wld_getplayerportalguild(vm); });
+  bindExternal("wld_getformerplayerportalguild",
+                                      [this](Daedalus::DaedalusVM& vm){ wld_getformerplayerportalguild(vm); });
+  bindExternal("wld_setguildattitude",[this](Daedalus::DaedalusVM& vm){ wld_setguildattitude(vm);     });
+  bindExternal("wld_getguildattitude",[this](Daedalus::DaedalusVM& vm){ wld_getguildattitude(vm);     });
+  bindExternal("wld_istime",          [this](Daedalus::DaedalusVM& vm){ wld_istime(vm);               });
+  bindExternal("wld_isfpavailable",   [this](Daedalus::DaedalusVM& vm){ wld_isfpavailable(vm);        });
+  bindExternal("wld_isnextfpavailable",
+                                      [this](Daedalus::DaedalusVM& vm){ wld_isnextfpavailable(vm);    });
+  bindExternal("wld_ismobavailable",  [this](Daedalus::DaedalusVM& vm){ wld_ismobavailable(vm);       });
+  bindExternal("wld_setmobroutine",   [this](Daedalus::DaedalusVM& vm){ wld_setmobroutine(vm);        });
+  bindExternal("wld_getmobstate",     [this](Daedalus::DaedalusVM& vm){ wld_getmobstate(vm);          });
+  bindExternal("wld_assignroomtoguild",
+                                      [this](Daedalus::DaedalusVM& vm){ wld_assignroomtoguild(vm);    });
+  bindExternal("wld_detectnpc",       [this](Daedalus::DaedalusVM& vm){ wld_detectnpc(vm);            });
+  bindExternal("wld_detectnpcex",     [this](Daedalus::DaedalusVM& vm){ wld_detectnpcex(vm);          });
+  bindExternal("wld_detectitem",      [this](Daedalus::DaedalusVM& vm){ wld_detectitem(vm);           });
+  bindExternal("wld_spawnnpcrange",   [this](Daedalus::DaedalusVM& vm){ wld_spawnnpcrange(vm);        });
+  bindExternal("wld_sendtrigger",     [this](Daedalus::DaedalusVM& vm){ wld_sendtrigger(vm);          });
+  bindExternal("wld_senduntrigger",   [this](Daedalus::DaedalusVM& vm){ wld_senduntrigger(vm);        });
+  bindExternal("wld_israining",       [this](Daedalus::DaedalusVM& vm){ wld_israining(vm);            });
+
+  bindExternal("mdl_setvisual",       [this](Daedalus::DaedalusVM& vm){ mdl_setvisual(vm);        });
+  bindExternal("mdl_setvisualbody",   [this](Daedalus::DaedalusVM& vm){ mdl_setvisualbody(vm);    });
+  bindExternal("mdl_setmodelfatness", [this](Daedalus::DaedalusVM& vm){ mdl_setmodelfatness(vm);  });
+  bindExternal("mdl_applyoverlaymds", [this](Daedalus::DaedalusVM& vm){ mdl_applyoverlaymds(vm);  });
+  bindExternal("mdl_applyoverlaymdstimed",
+                                      [this](Daedalus::DaedalusVM& vm){ mdl_applyoverlaymdstimed(vm); });
+  bindExternal("mdl_removeoverlaymds",[this](Daedalus::DaedalusVM& vm){ mdl_removeoverlaymds(vm); });
+  bindExternal("mdl_setmodelscale",   [this](Daedalus::DaedalusVM& vm){ mdl_setmodelscale(vm);    });
+  bindExternal("mdl_startfaceani",    [this](Daedalus::DaedalusVM& vm){ mdl_startfaceani(vm);     });
+  bindExternal("mdl_applyrandomani",  [this](Daedalus::DaedalusVM& vm){ mdl_applyrandomani(vm);   });
+  bindExternal("mdl_applyrandomanifreq",
+                                      [this](Daedalus::DaedalusVM& vm){ mdl_applyrandomanifreq(vm);});
+  bindExternal("mdl_applyrandomfaceani",
+                                      [this](Daedalus::DaedalusVM& vm){ mdl_applyrandomfaceani(vm);});
+
+  bindExternal("npc_settofightmode",  [this](Daedalus::DaedalusVM& vm){ npc_settofightmode(vm);   });
+  bindExternal("npc_settofistmode",   [this](Daedalus::DaedalusVM& vm){ npc_settofistmode(vm);    });
+  bindExternal("npc_isinstate",       [this](Daedalus::DaedalusVM& vm){ npc_isinstate(vm);        });
+  bindExternal("npc_isinroutine",     [this](Daedalus::DaedalusVM& vm){ npc_isinroutine(vm);      });
+  bindExternal("npc_wasinstate",      [this](Daedalus::DaedalusVM& vm){ npc_wasinstate(vm);       });
+  bindExternal("npc_getdisttowp",     [this](Daedalus::DaedalusVM& vm){ npc_getdisttowp(vm);      });
+  bindExternal("npc_exchangeroutine", [this](Daedalus::DaedalusVM& vm){ npc_exchangeroutine(vm);  });
+  bindExternal("npc_isdead",          [this](Daedalus::DaedalusVM& vm){ npc_isdead(vm);           });
+  bindExternal("npc_knowsinfo",       [this](Daedalus::DaedalusVM& vm){ npc_knowsinfo(vm);        });
+  bindExternal("npc_settalentskill",  [this](Daedalus::DaedalusVM& vm){ npc_settalentskill(vm);   });
+  bindExternal("npc_gettalentskill",  [this](Daedalus::DaedalusVM& vm){ npc_gettalentskill(vm);   });
+  bindExternal("npc_settalentvalue",  [this](Daedalus::DaedalusVM& vm){ npc_settalentvalue(vm);   });
+  bindExternal("npc_gettalentvalue",  [this](Daedalus::DaedalusVM& vm){ npc_gettalentvalue(vm);   });
+  bindExternal("npc_setrefusetalk",   [this](Daedalus::DaedalusVM& vm){ npc_setrefusetalk(vm);    });
+  bindExternal("npc_refusetalk",      [this](Daedalus::DaedalusVM& vm){ npc_refusetalk(vm);       });
+  bindExternal("npc_hasitems",        [this](Daedalus::DaedalusVM& vm){ npc_hasitems(vm);         });
+  bindExternal("npc_getinvitem",      [this](Daedalus::DaedalusVM& vm){ npc_getinvitem(vm);       });
+  bindExternal("npc_removeinvitem",   [this](Daedalus::DaedalusVM& vm){ npc_removeinvitem(vm);    });
+  bindExternal("npc_removeinvitems",  [this](Daedalus::DaedalusVM& vm){ npc_removeinvitems(vm);   });
+  bindExternal("npc_getbodystate",    [this](Daedalus::DaedalusVM& vm){ npc_getbodystate(vm);     });
+  bindExternal("npc_getlookattarget", [this](Daedalus::DaedalusVM& vm){ npc_getlookattarget(vm);  });
+  bindExternal("npc_getdisttonpc",    [this](Daedalus::DaedalusVM& vm){ npc_getdisttonpc(vm);     });
+  bindExternal("npc_hasequippedarmor",[this](Daedalus::DaedalusVM& vm){ npc_hasequippedarmor(vm); });
+  bindExternal("npc_setperctime",     [this](Daedalus::DaedalusVM& vm){ npc_setperctime(vm);      });
+  bindExternal("npc_percenable",      [this](Daedalus::DaedalusVM& vm){ npc_percenable(vm);       });
+  bindExternal("npc_percdisable",     [this](Daedalus::DaedalusVM& vm){ npc_percdisable(vm);      });
+  bindExternal("npc_getnearestwp",    [this](Daedalus::DaedalusVM& vm){ npc_getnearestwp(vm);     });
+  bindExternal("npc_clearaiqueue",    [this](Daedalus::DaedalusVM& vm){ npc_clearaiqueue(vm);     });
+  bindExternal("npc_isplayer",        [this](Daedalus::DaedalusVM& vm){ npc_isplayer(vm);         });
+  bindExternal("npc_getstatetime",    [this](Daedalus::DaedalusVM& vm){ npc_getstatetime(vm);     });
+  bindExternal("npc_setstatetime",    [this](Daedalus::DaedalusVM& vm){ npc_setstatetime(vm);     });
+  bindExternal("npc_changeattribute", [this](Daedalus::DaedalusVM& vm){ npc_changeattribute(vm);  });
+  bindExternal("npc_isonfp",          [this](Daedalus::DaedalusVM& vm){ npc_isonfp(vm);           });
+  bindExternal("npc_getheighttonpc",  [this](Daedalus::DaedalusVM& vm){ npc_getheighttonpc(vm);   });
+  bindExternal("npc_getequippedmeleeweapon",
+                                      [this](Daedalus::DaedalusVM& vm){ npc_getequippedmeleeweapon(vm); });
+  bindExternal("npc_getequippedrangedweapon",
+                                      [this](Daedalus::DaedalusVM& vm){ npc_getequippedrangedweapon(vm); });
+  bindExternal("npc_getequippedarmor",[this](Daedalus::DaedalusVM& vm){ npc_getequippedarmor(vm); });
+  bindExternal("npc_canseenpc",       [this](Daedalus::DaedalusVM& vm){ npc_canseenpc(vm);        });
+  bindExternal("npc_hasequippedweapon",
+                                      [this](Daedalus::DaedalusVM& vm){ npc_hasequippedweapon(vm); });
+  bindExternal("npc_hasequippedmeleeweapon",
+                                      [this](Daedalus::DaedalusVM& vm){ npc_hasequippedmeleeweapon(vm); });
+  bindExternal("npc_hasequippedrangedweapon",
+                                      [this](Daedalus::DaedalusVM& vm){ npc_hasequippedrangedweapon(vm); });
+  bindExternal("npc_getactivespell",  [this](Daedalus::DaedalusVM& vm){ npc_getactivespell(vm);   });
+  bindExternal("npc_getactivespellisscroll",
+                                      [this](Daedalus::DaedalusVM& vm){ npc_getactivespellisscroll(vm); });
+  bindExternal("npc_getactivespellcat",
+                                      [this](Daedalus::DaedalusVM& vm){ npc_getactivespellcat(vm); });
+  bindExternal("npc_setactivespellinfo",
+                                      [this](Daedalus::DaedalusVM& vm){ npc_setactivespellinfo(vm); });
+  bindExternal("npc_getactivespelllevel",
+                                      [this](Daedalus::DaedalusVM& vm){ npc_getactivespelllevel(vm); });
+
+  bindExternal("npc_canseenpcfreelos",[this](Daedalus::DaedalusVM& vm){ npc_canseenpcfreelos(vm); });
+  bindExternal("npc_isinfightmode",   [this](Daedalus::DaedalusVM& vm){ npc_isinfightmode(vm);    });
+  bindExternal("npc_settarget",       [this](Daedalus::DaedalusVM& vm){ npc_settarget(vm);        });
+  bindExternal("npc_gettarget",       [this](Daedalus::DaedalusVM& vm){ npc_gettarget(vm);        });
+  bindExternal("npc_getnexttarget",   [this](Daedalus::DaedalusVM& vm){ npc_getnexttarget(vm);    });
+  bindExternal("npc_sendpassiveperc", [this](Daedalus::DaedalusVM& vm){ npc_sendpassiveperc(vm);  });
+  bindExternal("npc_checkinfo",       [this](Daedalus::DaedalusVM& vm){ npc_checkinfo(vm);        });
+  bindExternal("npc_getportalguild",  [this](Daedalus::DaedalusVM& vm){ npc_getportalguild(vm);   });
+  bindExternal("npc_isinplayersroom", [this](Daedalus::DaedalusVM& vm){ npc_isinplayersroom(vm);  });
+  bindExternal("npc_getreadiedweapon",[this](Daedalus::DaedalusVM& vm){ npc_getreadiedweapon(vm); });
+  bindExternal("npc_hasreadiedmeleeweapon",
+                                      [this](Daedalus::DaedalusVM& vm){ npc_hasreadiedmeleeweapon(vm); });
+  bindExternal("npc_isdrawingspell",  [this](Daedalus::DaedalusVM& vm){ npc_isdrawingspell(vm);   });
+  bindExternal("npc_isdrawingweapon", [this](Daedalus::DaedalusVM& vm){ npc_isdrawingweapon(vm);  });
+  bindExternal("npc_perceiveall",     [this](Daedalus::DaedalusVM& vm){ npc_perceiveall(vm);      });
+  bindExternal("npc_stopani",         [this](Daedalus::DaedalusVM& vm){ npc_stopani(vm);          });
+  bindExternal("npc_settrueguild",    [this](Daedalus::DaedalusVM& vm){ npc_settrueguild(vm);     });
+  bindExternal("npc_gettrueguild",    [this](Daedalus::DaedalusVM& vm){ npc_gettrueguild(vm);     });
+  bindExternal("npc_clearinventory",  [this](Daedalus::DaedalusVM& vm){ npc_clearinventory(vm);   });
+  bindExternal("npc_getattitude",     [this](Daedalus::DaedalusVM& vm){ npc_getattitude(vm);      });
+  bindExternal("npc_getpermattitude", [this](Daedalus::DaedalusVM& vm){ npc_getpermattitude(vm);  });
+  bindExternal("npc_setattitude",     [this](Daedalus::DaedalusVM& vm){ npc_setattitude(vm);      });
+  bindExternal("npc_settempattitude", [this](Daedalus::DaedalusVM& vm){ npc_settempattitude(vm);  });
+  bindExternal("npc_hasbodyflag",     [this](Daedalus::DaedalusVM& vm){ npc_hasbodyflag(vm);      });
+  bindExternal("npc_getlasthitspellid",
+                                      [this](Daedalus::DaedalusVM& vm){ npc_getlasthitspellid(vm);});
+  bindExternal("npc_getlasthitspellcat",
+                                      [this](Daedalus::DaedalusVM& vm){ npc_getlasthitspellcat(vm);});
+  bindExternal("npc_playani",         [this](Daedalus::DaedalusVM& vm){ npc_playani(vm);          });
+
+  bindExternal("npc_isdetectedmobownedbynpc",
+                                      [this](Daedalus::DaedalusVM& vm){ npc_isdetectedmobownedbynpc(vm);});
+  bindExternal("npc_getdetectedmob",  [this](Daedalus::DaedalusVM& vm){ npc_getdetectedmob(vm);   });
+  bindExternal("npc_isdetectedmobownedbyguild",
+                                      [this](Daedalus::DaedalusVM& vm) { npc_isdetectedmobownedbyguild(vm); });
+  bindExternal("npc_ownedbynpc",      [this](Daedalus::DaedalusVM& vm){ npc_ownedbynpc(vm);       });
+  bindExternal("npc_canseesource",    [this](Daedalus::DaedalusVM& vm){ npc_canseesource(vm);     });
+  bindExternal("npc_getdisttoitem",   [this](Daedalus::DaedalusVM& vm){ npc_getdisttoitem(vm);    });
+  bindExternal("npc_getheighttoitem", [this](Daedalus::DaedalusVM& vm){ npc_getheighttoitem(vm);  });
+  bindExternal("npc_getdisttoplayer", [this](Daedalus::DaedalusVM& vm){ npc_getdisttoplayer(vm);  });
+
+  bindExternal("ai_output",           [this](Daedalus::DaedalusVM& vm){ ai_output(vm);            });
+  bindExternal("ai_stopprocessinfos", [this](Daedalus::DaedalusVM& vm){ ai_stopprocessinfos(vm);  });
+  bindExternal("ai_processinfos",     [this](Daedalus::DaedalusVM& vm){ ai_processinfos(vm);      });
+  bindExternal("ai_standup",          [this](Daedalus::DaedalusVM& vm){ ai_standup(vm);           });
+  bindExternal("ai_standupquick",     [this](Daedalus::DaedalusVM& vm){ ai_standupquick(vm);      });
+  bindExternal("ai_continueroutine",  [this](Daedalus::DaedalusVM& vm){ ai_continueroutine(vm);   });
+  bindExternal("ai_stoplookat",       [this](Daedalus::DaedalusVM& vm){ ai_stoplookat(vm);        });
+  bindExternal("ai_lookatnpc",        [this](Daedalus::DaedalusVM& vm){ ai_lookatnpc(vm);         });
+  bindExternal("ai_removeweapon",     [this](Daedalus::DaedalusVM& vm){ ai_removeweapon(vm);      });
+  bindExternal("ai_turntonpc",        [this](Daedalus::DaedalusVM& vm){ ai_turntonpc(vm);         });
+  bindExternal("ai_outputsvm",        [this](Daedalus::DaedalusVM& vm){ ai_outputsvm(vm);         });
+  bindExternal("ai_outputsvm_overlay",[this](Daedalus::DaedalusVM& vm){ ai_outputsvm_overlay(vm); });
+  bindExternal("ai_startstate",       [this](Daedalus::DaedalusVM& vm){ ai_startstate(vm);        });
+  bindExternal("ai_playani",          [this](Daedalus::DaedalusVM& vm){ ai_playani(vm);           });
+  bindExternal("ai_setwalkmode",      [this](Daedalus::DaedalusVM& vm){ ai_setwalkmode(vm);       });
+  bindExternal("ai_wait",             [this](Daedalus::DaedalusVM& vm){ ai_wait(vm);              });
+  bindExternal("ai_waitms",           [this](Daedalus::DaedalusVM& vm){ ai_waitms(vm);            });
+  bindExternal("ai_aligntowp",        [this](Daedalus::DaedalusVM& vm){ ai_aligntowp(vm);         });
+  bindExternal("ai_gotowp",           [this](Daedalus::DaedalusVM& vm){ ai_gotowp(vm);            });
+  bindExternal("ai_gotofp",           [this](Daedalus::DaedalusVM& vm){ ai_gotofp(vm);            });
+  bindExternal("ai_playanibs",        [this](Daedalus::DaedalusVM& vm){ ai_playanibs(vm);         });
+  bindExternal("ai_equiparmor",       [this](Daedalus::DaedalusVM& vm){ ai_equiparmor(vm);        });
+  bindExternal("ai_equipbestarmor",   [this](Daedalus::DaedalusVM& vm){ ai_equipbestarmor(vm);    });
+  bindExternal("ai_equipbestmeleeweapon",
+                                      [this](Daedalus::DaedalusVM& vm){ ai_equipbestmeleeweapon(vm);  });
+  bindExternal("ai_equipbestrangedweapon",
+                                      [this](Daedalus::DaedalusVM& vm){ ai_equipbestrangedweapon(vm); });
+  bindExternal("ai_usemob",           [this](Daedalus::DaedalusVM& vm){ ai_usemob(vm);            });
+  bindExternal("ai_teleport",         [this](Daedalus::DaedalusVM& vm){ ai_teleport(vm);          });
+  bindExternal("ai_stoppointat",      [this](Daedalus::DaedalusVM& vm){ ai_stoppointat(vm);       });
+  bindExternal("ai_drawweapon",       [this](Daedalus::DaedalusVM& vm){ ai_drawweapon(vm);  });
+  bindExternal("ai_readymeleeweapon", [this](Daedalus::DaedalusVM& vm){ ai_readymeleeweapon(vm);  });
+  bindExternal("ai_readyrangedweapon",[this](Daedalus::DaedalusVM& vm){ ai_readyrangedweapon(vm); });
+  bindExternal("ai_readyspell",       [this](Daedalus::DaedalusVM& vm){ ai_readyspell(vm);        });
+  bindExternal("ai_attack",           [this](Daedalus::DaedalusVM& vm){ ai_atack(vm);             });
+  bindExternal("ai_flee",             [this](Daedalus::DaedalusVM& vm){ ai_flee(vm);              });
+  bindExternal("ai_dodge",            [this](Daedalus::DaedalusVM& vm){ ai_dodge(vm);             });
+  bindExternal("ai_unequipweapons",   [this](Daedalus::DaedalusVM& vm){ ai_unequipweapons(vm);    });
+  bindExternal("ai_unequiparmor",     [this](Daedalus::DaedalusVM& vm){ ai_unequiparmor(vm);      });
+  bindExternal("ai_gotonpc",          [this](Daedalus::DaedalusVM& vm){ ai_gotonpc(vm);           });
+  bindExternal("ai_gotonextfp",       [this](Daedalus::DaedalusVM& vm){ ai_gotonextfp(vm);        });
+  bindExternal("ai_aligntofp",        [this](Daedalus::DaedalusVM& vm){ ai_aligntofp(vm);         });
+  bindExternal("ai_useitem",          [this](Daedalus::DaedalusVM& vm){ ai_useitem(vm);           });
+  bindExternal("ai_useitemtostate",   [this](Daedalus::DaedalusVM& vm){ ai_useitemtostate(vm);    });
+  bindExternal("ai_setnpcstostate",   [this](Daedalus::DaedalusVM& vm){ ai_setnpcstostate(vm);    });
+  bindExternal("ai_finishingmove",    [this](Daedalus::DaedalusVM& vm){ ai_finishingmove(vm);     });
+  bindExternal("ai_takeitem",         [this](Daedalus::DaedalusVM& vm){ ai_takeitem(vm);          });
+  bindExternal("ai_gotoitem",         [this](Daedalus::DaedalusVM& vm){ ai_gotoitem(vm);          });
+  bindExternal("ai_pointat",          [this](Daedalus::DaedalusVM& vm){ ai_pointat(vm);           });
+  bindExternal("ai_pointatnpc",       [this](Daedalus::DaedalusVM& vm){ ai_pointatnpc(vm);        });
+
+  bindExternal("mob_hasitems",        [this](Daedalus::DaedalusVM& vm){ mob_hasitems(vm);         });
+
+  bindExternal("ta_min",              [this](Daedalus::DaedalusVM& vm){ ta_min(vm);               });
+
+  bindExternal("log_createtopic",     [this](Daedalus::DaedalusVM& vm){ log_createtopic(vm);      });
+  bindExternal("log_settopicstatus",  [this](Daedalus::DaedalusVM& vm){ log_settopicstatus(vm);   });
+  bindExternal("log_addentry",        [this](Daedalus::DaedalusVM& vm){ log_addentry(vm);         });
+
+  bindExternal("equipitem",           [this](Daedalus::DaedalusVM& vm){ equipitem(vm);            });
+  bindExternal("createinvitem",       [this](Daedalus::DaedalusVM& vm){ createinvitem(vm);        });
+  bindExternal("createinvitems",      [this](Daedalus::DaedalusVM& vm){ createinvitems(vm);       });
+
+  bindExternal("info_addchoice",      [this](Daedalus::DaedalusVM& vm){ info_addchoice(vm);       });
+  bindExternal("info_clearchoices",   [this](Daedalus::DaedalusVM& vm){ info_clearchoices(vm);    });
+  bindExternal("infomanager_hasfinished",
+                                      [this](Daedalus::DaedalusVM& vm){ infomanager_hasfinished(vm); });
+
+  bindExternal("snd_play",            [this](Daedalus::DaedalusVM& vm){ snd_play(vm);             });
+  bindExternal("snd_play3d",          [this](Daedalus::DaedalusVM& vm){ snd_play3d(vm);           });
+
+  bindExternal("game_initgerman",     [this](Daedalus::DaedalusVM& vm){ game_initgerman(vm);      });
+  bindExternal("game_initenglish",    [this](Daedalus::DaedalusVM& vm){ game_initenglish(vm);     });
+
+  bindExternal("exitsession",         [this](Daedalus::DaedalusVM& vm){ exitsession(vm);          });
 
   // vm.validateExternals();
 
@@ -321,6 +349,7 @@ void GameScript::initCommon() {
 
   spellFxInstanceNames = dat.getSymbolIndexByName("spellFxInstanceNames");
   spellFxAniLetters    = dat.getSymbolIndexByName("spellFxAniLetters");
+  initSymbols();
 
   if(owner.version().game==2){
     auto& currency = dat.getSymbolByName("TRADE_CURRENCY_INSTANCE");
@@ -411,6 +440,75 @@ void GameScript::initCommon() {
     runFunction("startup_global");
   }
 
+void GameScript::initSymbols() {
+  G_CanNotUse                        = getSymbolIndex("G_CanNotUse");
+  G_CanNotCast                       = getSymbolIndex("G_CanNotCast");
+  G_PickLock                         = getSymbolIndex("G_PickLock");
+  Spell_ProcessMana                  = getSymbolIndex("Spell_ProcessMana");
+  C_CanNpcCollideWithSpell           = getSymbolIndex("C_CanNpcCollideWithSpell");
+  player_trade_not_enough_gold       = getSymbolIndex("player_trade_not_enough_gold");
+  player_mob_missing_item            = getSymbolIndex("player_mob_missing_item");
+  player_mob_missing_key             = getSymbolIndex("player_mob_missing_key");
+  player_mob_another_is_using        = getSymbolIndex("player_mob_another_is_using");
+  player_mob_missing_key_or_lockpick = getSymbolIndex("player_mob_missing_key_or_lockpick");
+  player_mob_missing_lockpick        = getSymbolIndex("player_mob_missing_lockpick");
+  player_mob_too_far_away            = getSymbolIndex("player_mob_too_far_away");
+  player_plunder_is_empty            = getSymbolIndex("player_plunder_is_empty");
+  player_hotkey_screen_map           = getSymbolIndex("player_hotkey_screen_map");
+  PLAYER_PERC_ASSESSMAGIC            = getSymbolIndex("PLAYER_PERC_ASSESSMAGIC");
+  NPC_DAM_DIVE_TIME                  = getSymbolIndex("NPC_DAM_DIVE_TIME");
+
+  // externals, that are safe to replay on npc-prototype; anything else makes instance non-cacheable
+  static const char* protoSafe[] = {
+    "mdl_setvisual", "mdl_setvisualbody", "mdl_setmodelfatness", "mdl_applyoverlaymds", "mdl_setmodelscale",
+    "npc_settalentskill", "npc_settalentvalue", "npc_settofistmode",
+    "createinvitem", "createinvitems", "ta_min",
+    };
+  npcProto.clear();
+  npcProtoSafe.clear();
+  for(auto name:protoSafe) {
+    size_t id = getSymbolIndex(name);
+    if(id!=size_t(-1))
+      npcProtoSafe.push_back(id);
+    }
+  std::sort(npcProtoSafe.begin(),npcProtoSafe.end());
+
+  // mutable globals (no locals and class members), that instance constructors may depend on
+  npcProtoVars.clear();
+  auto& dat = vm.getDATFile();
+  for(size_t i=0; i<dat.getSymTable().symbols.size(); ++i) {
+    auto& s = dat.getSymbolByIndex(i);
+    if((s.properties.elemProps.flags & Daedalus::EParFlag_Const)!=0 || s.name.find('.')!=std::string::npos)
+      continue;
+    switch(s.properties.elemProps.type) {
+      case Daedalus::EParType::EParType_Int:
+      case Daedalus::EParType::EParType_Float:
+      case Daedalus::EParType::EParType_String:
+        npcProtoVars.push_back(i);
+        break;
+      }
+    }
+
+  spellSym.clear();
+  if(spellFxInstanceNames==size_t(-1))
+    return;
+
+  auto& spellInst = vm.getDATFile().getSymbolByIndex(spellFxInstanceNames);
+  spellSym.resize(spellInst.strData.size());
+  for(size_t i=0; i<spellSym.size(); ++i) {
+    auto& tag = spellInst.getString(i);
+    auto& spl = spellSym[i];
+
+    char buf[256]={};
+    std::snprintf(buf,sizeof(buf),"Spell_Cast_%s",tag.c_str());
+    spl.castFn = getSymbolIndex(buf);
+
+    std::snprintf(buf,sizeof(buf),"spellFX_%s",tag.c_str());
+    spl.fxName = buf;
+    spl.desc   = &spells->find(tag.c_str());
+    }
+  }
+
 void GameScript::initDialogs() {
   loadDialogOU();
   if(!dialogs)
@@ -428,6 +526,16 @@ void GameScript::initDialogs() {
     vm.initializeInstance(h, i, Daedalus::IC_Info);
     ++count;
     });
+
+  dlgByNpc.clear();
+  for(auto& info:dialogsInfo)
+    dlgByNpc[size_t(info.npc)].push_back(&info);
+  for(auto& i:dlgByNpc) {
+    std::stable_sort(i.second.begin(),i.second.end(),[](const Daedalus::GEngineClasses::C_Info* l,
+                                                         const Daedalus::GEngineClasses::C_Info* r){
+      return std::make_tuple(-l->important,l->nr) < std::make_tuple(-r->important,r->nr);
+      });
+    }
   }
 
 void GameScript::loadDialogOU() {
@@ -453,7 +561,72 @@ void GameScript::loadDialogOU() {
     }
   }
 
+void GameScript::initializeNpc(Npc& npc, size_t instance) {
+  auto& hnpc = *npc.handle();
+  auto  it   = npcProto.find(instance);
+  const uint64_t globals = globalsHash();
+  if(it!=npcProto.end() && it->second.globals==globals) {
+    ScriptProfiler::Scope scope(profiler,instance);
+    auto& p        = it->second;
+    auto  wp       = std::move(hnpc.wp);
+    auto  useCount = hnpc.useCount;
+    hnpc           = p.hnpc;
+    hnpc.userPtr   = &npc;
+    hnpc.useCount  = useCount;
+    hnpc.wp        = std::move(wp);
+    vm.getDATFile().getSymbolByIndex(instance).instance.set(&hnpc,Daedalus::IC_Npc);
+    for(auto& fn:p.apply)
+      fn(npc);
+    return;
+    }
+
+  if(npcRec!=nullptr) {
+    // nested spawn from constructor - outer one is non-cacheable anyway
+    initializeInstance(hnpc,instance);
+    return;
+    }
+
+  NpcProto rec;
+  npcRec     = &rec;
+  npcRecSelf = &npc;
+  initializeInstance(hnpc,instance);
+  npcRec     = nullptr;
+  npcRecSelf = nullptr;
+
+  // constructor, that writes globals, is not replayable
+  if(!rec.valid || globalsHash()!=globals) {
+    npcProto.erase(instance);
+    return;
+    }
+  rec.globals = globals;
+  rec.hnpc = hnpc;
+  rec.hnpc.userPtr  = nullptr;
+  rec.hnpc.useCount = 0;
+  npcProto[instance] = std::move(rec);
+  }
+
+uint64_t GameScript::globalsHash() {
+  auto&    dat = vm.getDATFile();
+  uint64_t h   = 0xcbf29ce484222325ull;
+  auto     mix = [&h](const void* data, size_t size) {
+    auto b = reinterpret_cast<const uint8_t*>(data);
+    for(size_t i=0; i<size; ++i) {
+      h ^= b[i];
+      h *= 0x100000001b3ull;
+      }
+    };
+  for(auto i:npcProtoVars) {
+    auto& s = dat.getSymbolByIndex(i);
+    mix(s.intData.data(),  s.intData.size()  *sizeof(s.intData[0]));
+    mix(s.floatData.data(),s.floatData.size()*sizeof(s.floatData[0]));
+    for(auto& str:s.strData)
+      mix(str.data(),str.size()+1);
+    }
+  return h;
+  }
+
 void GameScript::initializeInstance(Daedalus::GEngineClasses::C_Npc &n, size_t instance) {
+  ScriptProfiler::Scope scope(profiler,instance);
   vm.initializeInstance(n,instance,Daedalus::IC_Npc);
 
   if(n.daily_routine!=0) {
@@ -549,6 +722,8 @@ void GameScript::loadVar(Serialize &fin) {
   }
 
 void GameScript::resetVarPointers() {
+  // prototypes reference waypoints of previous world
+  npcProto.clear();
   auto&  dat = vm.getDATFile().getSymTable().symbols;
   for(size_t i=0;i<dat.size();++i){
     auto& s = vm.getDATFile().getSymbolByIndex(i);
@@ -661,6 +836,9 @@ void GameScript::storeItem(Item *itm) {
   }
 
 Daedalus::PARSymbol &GameScript::getSymbol(std::string_view s) {
+  auto id = symIndex.find(s);
+  if(id!=size_t(-1))
+    return vm.getDATFile().getSymbolByIndex(id);
   char buf[256] = {};
   std::snprintf(buf,sizeof(buf),"%.*s",int(s.size()),s.data());
   return vm.getDATFile().getSymbolByName(buf);
@@ -671,6 +849,8 @@ Daedalus::PARSymbol &GameScript::getSymbol(const size_t s) {
   }
 
 size_t GameScript::getSymbolIndex(std::string_view s) {
+  if(!symIndex.isEmpty())
+    return symIndex.find(s);
   char buf[256] = {};
   std::snprintf(buf,sizeof(buf),"%.*s",int(s.size()),s.data());
   return vm.getDATFile().getSymbolIndexByName(buf);
@@ -689,12 +869,16 @@ const AiState& GameScript::aiState(ScriptFn id) {
   }
 
 const Daedalus::GEngineClasses::C_Spell& GameScript::spellDesc(int32_t splId) {
+  if(size_t(splId)<spellSym.size())
+    return *spellSym[size_t(splId)].desc;
   auto& spellInst = vm.getDATFile().getSymbolByIndex(spellFxInstanceNames);
   auto& tag       = spellInst.getString(size_t(splId));
   return spells->find(tag.c_str());
   }
 
 const VisualFx* GameScript::spellVfx(int32_t splId) {
+  if(size_t(splId)<spellSym.size())
+    return Gothic::inst().loadVisualFx(spellSym[size_t(splId)].fxName);
   auto& spellInst = vm.getDATFile().getSymbolByIndex(spellFxInstanceNames);
   auto& tag       = spellInst.getString(size_t(splId));
 
@@ -713,12 +897,7 @@ std::vector<GameScript::DlgChoise> GameScript::dialogChoises(Daedalus::GEngineCl
   ScopeVar self (vm, vm.globalSelf(),  hnpc,   Daedalus::IC_Npc);
   ScopeVar other(vm, vm.globalOther(), player, Daedalus::IC_Npc);
 
-  std::vector<Daedalus::GEngineClasses::C_Info*> hDialog;
-  for(auto& info : dialogsInfo) {
-    if(info.npc==int32_t(npc.instanceSymbol)) {
-      hDialog.push_back(&info);
-      }
-    }
+  auto& hDialog = npcDialogs(npc.instanceSymbol);
 
   std::vector<DlgChoise> choise;
 
@@ -812,7 +991,7 @@ void GameScript::exec(const GameScript::DlgChoise &dlg,Npc& player, Npc& npc) {
   }
 
 int GameScript::printCannotUseError(Npc& npc, int32_t atr, int32_t nValue) {
-  auto id = vm.getDATFile().getSymbolIndexByName("G_CanNotUse");
+  auto id = G_CanNotUse;
   if(id==size_t(-1))
     return 0;
   vm.pushInt(npc.isPlayer() ? 1 : 0);
@@ -823,7 +1002,7 @@ int GameScript::printCannotUseError(Npc& npc, int32_t atr, int32_t nValue) {
   }
 
 int GameScript::printCannotCastError(Npc &npc, int32_t plM, int32_t itM) {
-  auto id = vm.getDATFile().getSymbolIndexByName("G_CanNotCast");
+  auto id = G_CanNotCast;
   if(id==size_t(-1))
     return 0;
   vm.pushInt(npc.isPlayer() ? 1 : 0);
@@ -834,7 +1013,7 @@ int GameScript::printCannotCastError(Npc &npc, int32_t plM, int32_t itM) {
   }
 
 int GameScript::printCannotBuyError(Npc &npc) {
-  auto id = vm.getDATFile().getSymbolIndexByName("player_trade_not_enough_gold");
+  auto id = player_trade_not_enough_gold;
   if(id==size_t(-1))
     return 0;
   ScopeVar self(vm, vm.globalSelf(), npc.handle(), Daedalus::IC_Npc);
@@ -842,7 +1021,7 @@ int GameScript::printCannotBuyError(Npc &npc) {
   }
 
 int GameScript::printMobMissingItem(Npc &npc) {
-  auto id = vm.getDATFile().getSymbolIndexByName("player_mob_missing_item");
+  auto id = player_mob_missing_item;
   if(id==size_t(-1))
     return 0;
   ScopeVar self(vm, vm.globalSelf(), npc.handle(), Daedalus::IC_Npc);
@@ -850,7 +1029,7 @@ int GameScript::printMobMissingItem(Npc &npc) {
   }
 
 int GameScript::printMobMissingKey(Npc& npc) {
-  auto id = vm.getDATFile().getSymbolIndexByName("player_mob_missing_key");
+  auto id = player_mob_missing_key;
   if(id==size_t(-1))
     return 0;
   ScopeVar self(vm, vm.globalSelf(), npc.handle(), Daedalus::IC_Npc);
@@ -858,7 +1037,7 @@ int GameScript::printMobMissingKey(Npc& npc) {
   }
 
 int GameScript::printMobAnotherIsUsing(Npc &npc) {
-  auto id = vm.getDATFile().getSymbolIndexByName("player_mob_another_is_using");
+  auto id = player_mob_another_is_using;
   if(id==size_t(-1))
     return 0;
   ScopeVar self(vm, vm.globalSelf(), npc.handle(), Daedalus::IC_Npc);
@@ -866,7 +1045,7 @@ int GameScript::printMobAnotherIsUsing(Npc &npc) {
   }
 
 int GameScript::printMobMissingKeyOrLockpick(Npc& npc) {
-  auto id = vm.getDATFile().getSymbolIndexByName("player_mob_missing_key_or_lockpick");
+  auto id = player_mob_missing_key_or_lockpick;
   if(id==size_t(-1))
     return 0;
   ScopeVar self(vm, vm.globalSelf(), npc.handle(), Daedalus::IC_Npc);
@@ -874,7 +1053,7 @@ int GameScript::printMobMissingKeyOrLockpick(Npc& npc) {
   }
 
 int GameScript::printMobMissingLockpick(Npc& npc) {
-  auto id = vm.getDATFile().getSymbolIndexByName("player_mob_missing_lockpick");
+  auto id = player_mob_missing_lockpick;
   if(id==size_t(-1))
     return 0;
   ScopeVar self(vm, vm.globalSelf(), npc.handle(), Daedalus::IC_Npc);
@@ -882,7 +1061,7 @@ int GameScript::printMobMissingLockpick(Npc& npc) {
   }
 
 int GameScript::printMobTooFar(Npc& npc) {
-  auto id = vm.getDATFile().getSymbolIndexByName("player_mob_too_far_away");
+  auto id = player_mob_too_far_away;
   if(id==size_t(-1))
     return 0;
   ScopeVar self(vm, vm.globalSelf(), npc.handle(), Daedalus::IC_Npc);
@@ -890,8 +1069,7 @@ int GameScript::printMobTooFar(Npc& npc) {
   }
 
 int GameScript::invokeState(Daedalus::GEngineClasses::C_Npc* hnpc, Daedalus::GEngineClasses::C_Npc* oth, const char *name) {
-  auto& dat = vm.getDATFile();
-  auto  id  = dat.getSymbolIndexByName(name);
+  auto id = getSymbolIndex(name);
   if(id==size_t(-1))
     return 0;
 
@@ -938,8 +1116,7 @@ int GameScript::invokeItem(Npc *npc, ScriptFn fn) {
   }
 
 int GameScript::invokeMana(Npc &npc, Npc* target, Item &) {
-  auto& dat = vm.getDATFile();
-  auto fn   = dat.getSymbolIndexByName("Spell_ProcessMana");
+  auto fn = Spell_ProcessMana;
   if(fn==size_t(-1))
     return SpellCode::SPL_SENDSTOP;
 
@@ -951,13 +1128,10 @@ int GameScript::invokeMana(Npc &npc, Npc* target, Item &) {
   }
 
 int GameScript::invokeSpell(Npc &npc, Npc* target, Item &it) {
-  auto& spellInst = vm.getDATFile().getSymbolByIndex(spellFxInstanceNames);
-  auto& tag       = spellInst.getString(size_t(it.spellId()));
-  char  str[256]={};
-  std::snprintf(str,sizeof(str),"Spell_Cast_%s",tag.c_str());
-
-  auto& dat = vm.getDATFile();
-  auto  fn  = dat.getSymbolIndexByName(str);
+  const size_t splId = size_t(it.spellId());
+  if(splId>=spellSym.size())
+    return 0;
+  auto fn = spellSym[splId].castFn;
   if(fn==size_t(-1))
     return 0;
 
@@ -970,7 +1144,7 @@ int GameScript::invokeSpell(Npc &npc, Npc* target, Item &it) {
     return runFunction(fn);
     }
   catch(...){
-    Log::d("unable to call spell-script: \"",str,"\'");
+    Log::d("unable to call spell-script: \"",getSymbol(fn).name,"\'");
     return 0;
     }
   }
@@ -986,8 +1160,7 @@ int GameScript::invokeCond(Npc& npc, std::string_view func) {
   }
 
 void GameScript::invokePickLock(Npc& npc, int bSuccess, int bBrokenOpen) {
-  auto& dat = vm.getDATFile();
-  auto fn   = dat.getSymbolIndexByName("G_PickLock");
+  auto fn = G_PickLock;
   if(fn==size_t(-1))
     return;
   ScopeVar self(vm, vm.globalSelf(),  npc);
@@ -997,8 +1170,7 @@ void GameScript::invokePickLock(Npc& npc, int bSuccess, int bBrokenOpen) {
   }
 
 CollideMask GameScript::canNpcCollideWithSpell(Npc& npc, Npc* shooter, int32_t spellId) {
-  auto& dat = vm.getDATFile();
-  auto fn   = dat.getSymbolIndexByName("C_CanNpcCollideWithSpell");
+  auto fn = C_CanNpcCollideWithSpell;
   if(fn==size_t(-1))
     return COLL_DOEVERYTHING;
 
@@ -1010,8 +1182,7 @@ CollideMask GameScript::canNpcCollideWithSpell(Npc& npc, Npc* shooter, int32_t s
   }
 
 int GameScript::playerHotKeyScreenMap(Npc& pl) {
-  auto& dat = vm.getDATFile();
-  auto fn   = dat.getSymbolIndexByName("player_hotkey_screen_map");
+  auto fn = player_hotkey_screen_map;
   if(fn==size_t(-1))
     return -1;
 
@@ -1103,7 +1274,7 @@ uint32_t GameScript::messageTime(const Daedalus::ZString& id) const {
   }
 
 int GameScript::printNothingToGet() {
-  auto id = vm.getDATFile().getSymbolIndexByName("player_plunder_is_empty");
+  auto id = player_plunder_is_empty;
   if(id==size_t(-1))
     return 0;
   ScopeVar self(vm, vm.globalSelf(), owner.player());
@@ -1111,13 +1282,13 @@ int GameScript::printNothingToGet() {
   }
 
 void GameScript::useInteractive(Daedalus::GEngineClasses::C_Npc* hnpc,const std::string& func) {
-  auto& dat = vm.getDATFile();
-  if(!dat.hasSymbolName(func.c_str()))
+  auto fn = getSymbolIndex(func);
+  if(fn==size_t(-1))
     return;
 
   ScopeVar self(vm,vm.globalSelf(),hnpc,Daedalus::IC_Npc);
   try {
-    runFunction(func.c_str());
+    runFunction(fn);
     }
   catch (...) {
     Log::i("unable to use interactive [",func,"]");
@@ -1189,15 +1360,15 @@ bool GameScript::searchScheme(std::string_view sc, std::string_view listName) {
   }
 
 bool GameScript::hasSymbolName(std::string_view s) {
+  if(!symIndex.isEmpty())
+    return symIndex.find(s)!=size_t(-1);
   char buf[256] = {};
   std::snprintf(buf,sizeof(buf),"%.*s",int(s.size()),s.data());
   return vm.getDATFile().hasSymbolName(buf);
   }
 
 int32_t GameScript::runFunction(std::string_view s) {
-  char buf[256] = {};
-  std::snprintf(buf,sizeof(buf),"%.*s",int(s.size()),s.data());
-  auto id = vm.getDATFile().getSymbolIndexByName(buf);
+  auto id = getSymbolIndex(s);
   if(id==size_t(-1))
     throw std::runtime_error("script bad call");
   return runFunction(id);
@@ -1208,6 +1379,7 @@ int32_t GameScript::runFunction(const size_t fid) {
   auto&       sym  = dat.getSymbolByIndex(fid);
   const char* call = sym.name.c_str();(void)call; //for debuging
 
+  ScriptProfiler::Scope scope(profiler,fid);
   int32_t ret = vm.runFunctionBySymIndex(fid);
   return ret;
   }
@@ -1325,7 +1497,7 @@ AiOuputPipe *GameScript::openDlgOuput(Npc &player, Npc &npc) {
   }
 
 ScriptFn GameScript::playerPercAssessMagic() {
-  size_t id = vm.getDATFile().getSymbolIndexByName("PLAYER_PERC_ASSESSMAGIC");
+  size_t id = PLAYER_PERC_ASSESSMAGIC;
   if(id==size_t(-1))
     return ScriptFn();
   auto& var = vm.getDATFile().getSymbolByIndex(id);
@@ -1336,7 +1508,7 @@ ScriptFn GameScript::playerPercAssessMagic() {
   }
 
 int GameScript::npcDamDiveTime() {
-  size_t id = vm.getDATFile().getSymbolIndexByName("NPC_DAM_DIVE_TIME");
+  size_t id = NPC_DAM_DIVE_TIME;
   if(id==size_t(-1))
     return 0;
   auto& var = vm.getDATFile().getSymbolByIndex(id);
@@ -1693,7 +1865,8 @@ void GameScript::mdl_setvisual(Daedalus::DaedalusVM &vm) {
   auto        npc    = popInstance(vm);
   if(npc==nullptr)
     return;
-  npc->setVisual(visual.c_str());
+  std::string name = visual.c_str();
+  npcApply(*npc,[name](Npc& n){ n.setVisual(name); });
   }
 
 void GameScript::mdl_setvisualbody(Daedalus::DaedalusVM &vm) {
@@ -1708,8 +1881,11 @@ void GameScript::mdl_setvisualbody(Daedalus::DaedalusVM &vm) {
 
   if(npc==nullptr)
     return;
-  npc->setVisualBody(headTexNr,teethTexNr,bodyTexNr,bodyTexColor,body.c_str(),head.c_str());
+  std::string bodyName = body.c_str(), headName = head.c_str();
+  npcApply(*npc,[=](Npc& n){ n.setVisualBody(headTexNr,teethTexNr,bodyTexNr,bodyTexColor,bodyName,headName); });
   if(armor>=0) {
+    // equip runs item scripts on npc attributes
+    npcProtoInvalidate();
     if(npc->hasItem(uint32_t(armor))==0)
       npc->addItem(uint32_t(armor),1);
     npc->useItem(uint32_t(armor),true);
@@ -1721,35 +1897,32 @@ void GameScript::mdl_setmodelfatness(Daedalus::DaedalusVM &vm) {
   auto     npc = popInstance(vm);
 
   if(npc!=nullptr)
-    npc->setFatness(fat);
+    npcApply(*npc,[fat](Npc& n){ n.setFatness(fat); });
   }
 
 void GameScript::mdl_applyoverlaymds(Daedalus::DaedalusVM &vm) {
-  auto overlayname = vm.popString();
+  auto overlayname = std::string(vm.popString().c_str());
   auto npc         = popInstance(vm);
-  auto skelet      = Resources::loadSkeleton(overlayname.c_str());
 
   if(npc!=nullptr)
-    npc->addOverlay(skelet,0);
+    npcApply(*npc,[overlayname](Npc& n){ n.addOverlay(overlayname,0); });
   }
 
 void GameScript::mdl_applyoverlaymdstimed(Daedalus::DaedalusVM &vm) {
   int32_t ticks       = vm.popInt();
   auto    overlayname = vm.popString();
   auto    npc         = popInstance(vm);
-  auto    skelet      = Resources::loadSkeleton(overlayname.c_str());
 
   if(npc!=nullptr && ticks>0)
-    npc->addOverlay(skelet,uint64_t(ticks));
+    npc->addOverlay(overlayname.c_str(),uint64_t(ticks));
   }
 
 void GameScript::mdl_removeoverlaymds(Daedalus::DaedalusVM &vm) {
   auto overlayname = vm.popString();
   auto npc         = popInstance(vm);
-  auto skelet      = Resources::loadSkeleton(overlayname.c_str());
 
   if(npc!=nullptr)
-    npc->delOverlay(skelet);
+    npc->delOverlay(overlayname);
   }
 
 void GameScript::mdl_setmodelscale(Daedalus::DaedalusVM &vm) {
@@ -1759,7 +1932,7 @@ void GameScript::mdl_setmodelscale(Daedalus::DaedalusVM &vm) {
   auto  npc = popInstance(vm);
 
   if(npc!=nullptr)
-    npc->setScale(x,y,z);
+    npcApply(*npc,[x,y,z](Npc& n){ n.setScale(x,y,z); });
   }
 
 void GameScript::mdl_startfaceani(Daedalus::DaedalusVM &vm) {
@@ -1846,7 +2019,7 @@ void GameScript::npc_settofightmode(Daedalus::DaedalusVM &vm) {
 void GameScript::npc_settofistmode(Daedalus::DaedalusVM &vm) {
   auto npc = popInstance(vm);
   if(npc!=nullptr)
-    npc->setToFistMode();
+    npcApply(*npc,[](Npc& n){ n.setToFistMode(); });
   }
 
 void GameScript::npc_isinstate(Daedalus::DaedalusVM &vm) {
@@ -1908,7 +2081,7 @@ void GameScript::npc_exchangeroutine(Daedalus::DaedalusVM &vm) {
     auto& v = *npc->handle();
     char buf[256]={};
     std::snprintf(buf,sizeof(buf),"Rtn_%s_%d",rname.c_str(),v.id);
-    size_t d = vm.getDATFile().getSymbolIndexByName(buf);
+    size_t d = getSymbolIndex(buf);
     if(d>0)
       npc->excRoutine(d);
     }
@@ -1939,7 +2112,7 @@ void GameScript::npc_settalentskill(Daedalus::DaedalusVM &vm) {
   int  t       = vm.popInt();
   auto npc     = popInstance(vm);
   if(npc!=nullptr)
-    npc->setTalentSkill(Talent(t),lvl);
+    npcApply(*npc,[t,lvl](Npc& n){ n.setTalentSkill(Talent(t),lvl); });
   }
 
 void GameScript::npc_gettalentskill(Daedalus::DaedalusVM &vm) {
@@ -1955,7 +2128,7 @@ void GameScript::npc_settalentvalue(Daedalus::DaedalusVM &vm) {
   int t    = vm.popInt();
   auto npc = popInstance(vm);
   if(npc!=nullptr)
-    npc->setTalentValue(Talent(t),lvl);
+    npcApply(*npc,[t,lvl](Npc& n){ n.setTalentValue(Talent(t),lvl); });
   }
 
 void GameScript::npc_gettalentvalue(Daedalus::DaedalusVM &vm) {
@@ -2363,8 +2536,9 @@ void GameScript::npc_checkinfo(Daedalus::DaedalusVM &vm) {
   auto& pl   = *(hpl);
   auto& npc  = *(n->handle());
 
-  for(auto& info:dialogsInfo) {
-    if(info.npc!=int32_t(npc.instanceSymbol) || info.important!=imp)
+  for(auto i:npcDialogs(npc.instanceSymbol)) {
+    auto& info = *i;
+    if(info.important!=imp)
       continue;
     bool npcKnowsInfo = doesNpcKnowInfo(pl,info.instanceSymbol);
     if(npcKnowsInfo && !info.permanent)
@@ -3095,7 +3269,7 @@ void GameScript::ta_min(Daedalus::DaedalusVM &vm) {
   auto     at       = world().findPoint(waypoint.c_str());
 
   if(npc!=nullptr)
-    npc->addRoutine(gtime(start_h,start_m),gtime(stop_h,stop_m),uint32_t(action),at);
+    npcApply(*npc,[=](Npc& n){ n.addRoutine(gtime(start_h,start_m),gtime(stop_h,stop_m),uint32_t(action),at); });
   }
 
 void GameScript::log_createtopic(Daedalus::DaedalusVM &vm) {
@@ -3139,8 +3313,7 @@ void GameScript::createinvitem(Daedalus::DaedalusVM &vm) {
   uint32_t itemInstance = uint32_t(vm.popInt());
   auto     self         = popInstance(vm);
   if(self!=nullptr) {
-    Item* itm = self->addItem(itemInstance,1);
-    storeItem(itm);
+    npcApply(*self,[this,itemInstance](Npc& n){ storeItem(n.addItem(itemInstance,1)); });
     }
   }
 
@@ -3149,8 +3322,7 @@ void GameScript::createinvitems(Daedalus::DaedalusVM &vm) {
   uint32_t itemInstance = vm.popUInt();
   auto     self         = popInstance(vm);
   if(self!=nullptr && amount>0) {
-    Item* itm = self->addItem(itemInstance,size_t(amount));
-    storeItem(itm);
+    npcApply(*self,[this,itemInstance,amount](Npc& n){ storeItem(n.addItem(itemInstance,size_t(amount))); });
     }
   }
 
@@ -3278,4 +3450,12 @@ bool GameScript::doesNpcKnowInfo(const Daedalus::GEngineClasses::C_Npc& npc, siz
   return dlgKnownInfos.find(id)!=dlgKnownInfos.end();
   }
 
+const std::vector<Daedalus::GEngineClasses::C_Info*>& GameScript::npcDialogs(size_t npcInstance) const {
+  static const std::vector<Daedalus::GEngineClasses::C_Info*> empty;
+  auto it = dlgByNpc.find(npcInstance);
+  if(it==dlgByNpc.end())
+    return empty;
+  return it->second;
+  }
+
 
@@ -7,6 +7,7 @@
 #include <memory>
 #include <unordered_set>
 #include <random>
+#include <functional>
 
 #include <Tempest/Matrix4x4>
 #include <Tempest/Painter>
@@ -18,6 +19,8 @@
 #include "game/constants.h"
 #include "game/aistate.h"
 #include "game/questlog.h"
+#include "game/symbolindex.h"
+#include "game/scriptprofiler.h"
 #include "graphics/pfx/pfxobjects.h"
 #include "ui/documentmenu.h"
 
@@ -64,6 +67,7 @@ class GameScript final {
     void         initDialogs ();
     void         loadDialogOU();
 
+    void         initializeNpc     (Npc& npc, size_t instance);
     void         initializeInstance(Daedalus::GEngineClasses::C_Npc&  n,  size_t instance);
     void         initializeInstance(Daedalus::GEngineClasses::C_Item& it, size_t instance);
     void         clearReferences(Daedalus::GEngineClasses::Instance& ptr);
@@ -105,6 +109,7 @@ class GameScript final {
     Daedalus::PARSymbol&                              getSymbol(const size_t s);
     size_t                                            getSymbolIndex(std::string_view s);
     size_t                                            getSymbolCount() const;
+    ScriptProfiler&                                   scriptProfiler() { return profiler; }
 
     const AiState&                                    aiState  (ScriptFn id);
     const Daedalus::GEngineClasses::C_Spell&          spellDesc(int32_t splId);
@@ -158,6 +163,14 @@ class GameScript final {
 
   private:
     void               initCommon();
+    void               initSymbols();
+
+    template<class F>
+    void               bindExternal(const char* name, F fn);
+    template<class F>
+    void               npcApply(Npc& npc, F fn);
+    void               npcProtoInvalidate();
+    uint64_t           globalsHash();
 
     struct GlobalOutput : AiOuputPipe {
       GlobalOutput(GameScript& owner):owner(owner){}
@@ -401,14 +414,31 @@ class GameScript final {
     void sort(std::vector<DlgChoise>& dlg);
     void setNpcInfoKnown(const Daedalus::GEngineClasses::C_Npc& npc, const Daedalus::GEngineClasses::C_Info& info);
     bool doesNpcKnowInfo(const Daedalus::GEngineClasses::C_Npc& npc, size_t infoInstance) const;
+    auto npcDialogs(size_t npcInstance) const -> const std::vector<Daedalus::GEngineClasses::C_Info*>&;
 
     void saveSym(Serialize& fout,const Daedalus::PARSymbol& s);
 
     void fixNpcPosition(Npc& npc, float angle0, float distBias);
     void onWldInstanceRemoved(const Daedalus::GEngineClasses::Instance* obj);
 
+    struct SpellSym final {
+      size_t                                   castFn = size_t(-1);
+      std::string                              fxName;
+      const Daedalus::GEngineClasses::C_Spell* desc   = nullptr;
+      };
+
+    // state, applied by constructor of npc-instance; replayed for next spawns of same instance
+    struct NpcProto final {
+      uint64_t                                 globals = 0;
+      bool                                     valid   = true;
+      Daedalus::GEngineClasses::C_Npc          hnpc;
+      std::vector<std::function<void(Npc&)>>   apply;
+      };
+
     Daedalus::DaedalusVM                                        vm;
     GameSession&                                                owner;
+    SymbolIndex                                                 symIndex;
+    ScriptProfiler                                              profiler;
     std::mt19937                                                randGen;
 
     std::unique_ptr<SpellDefinitions>                           spells;
@@ -417,6 +447,12 @@ class GameScript final {
 
     std::set<std::pair<size_t,size_t>>                          dlgKnownInfos;
     std::vector<Daedalus::GEngineClasses::C_Info>               dialogsInfo;
+    std::unordered_map<size_t,std::vector<Daedalus::GEngineClasses::C_Info*>> dlgByNpc;
+    std::unordered_map<size_t,NpcProto>                         npcProto;
+    std::vector<size_t>                                         npcProtoSafe;
+    std::vector<size_t>                                         npcProtoVars;
+    NpcProto*                                                   npcRec=nullptr;
+    Npc*                                                        npcRecSelf=nullptr;
     std::unique_ptr<ZenLoad::zCCSLib>                           dialogs;
     std::unordered_map<size_t,AiState>                          aiStates;
     std::unique_ptr<AiOuputPipe>                                aiDefaultPipe;
@@ -439,6 +475,24 @@ class GameScript final {
     size_t                                                      ZS_Attack=0;
     size_t                                                      ZS_MM_Attack=0;
 
+    size_t                                                      G_CanNotUse=size_t(-1);
+    size_t                                                      G_CanNotCast=size_t(-1);
+    size_t                                                      G_PickLock=size_t(-1);
+    size_t                                                      Spell_ProcessMana=size_t(-1);
+    size_t                                                      C_CanNpcCollideWithSpell=size_t(-1);
+    size_t                                                      player_trade_not_enough_gold=size_t(-1);
+    size_t                                                      player_mob_missing_item=size_t(-1);
+    size_t                                                      player_mob_missing_key=size_t(-1);
+    size_t                                                      player_mob_another_is_using=size_t(-1);
+    size_t                                                      player_mob_missing_key_or_lockpick=size_t(-1);
+    size_t                                                      player_mob_missing_lockpick=size_t(-1);
+    size_t                                                      player_mob_too_far_away=size_t(-1);
+    size_t                                                      player_plunder_is_empty=size_t(-1);
+    size_t                                                      player_hotkey_screen_map=size_t(-1);
+    size_t                                                      PLAYER_PERC_ASSESSMAGIC=size_t(-1);
+    size_t                                                      NPC_DAM_DIVE_TIME=size_t(-1);
+    std::vector<SpellSym>                                       spellSym;
+
     Daedalus::GEngineClasses::C_Focus                           cFocusNorm,cFocusMele,cFocusRange,cFocusMage;
     Daedalus::GEngineClasses::C_GilValues                       cGuildVal;
   };
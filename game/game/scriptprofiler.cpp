@@ -0,0 +1,100 @@
+#include "scriptprofiler.h"
+
+#include <Tempest/Log>
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+
+using namespace Tempest;
+
+ScriptProfiler::ScriptProfiler(Daedalus::DaedalusVM& vm):vm(vm) {
+  }
+
+void ScriptProfiler::setEnabled(bool e) {
+  if(enabled==e)
+    return;
+  enabled = e;
+  if(enabled && stat.empty())
+    stat.resize(vm.getDATFile().getSymTable().symbols.size());
+  // frames, opened before toggle, are not tracked
+  stack.clear();
+  }
+
+void ScriptProfiler::reset() {
+  stat.clear();
+  stack.clear();
+  if(enabled)
+    stat.resize(vm.getDATFile().getSymTable().symbols.size());
+  }
+
+bool ScriptProfiler::enter(size_t sym) {
+  if(sym>=stat.size())
+    return false;
+  Frame f;
+  f.sym   = sym;
+  f.start = clock::now();
+  stack.push_back(f);
+  stat[sym].depth++;
+  return true;
+  }
+
+void ScriptProfiler::leave() {
+  if(stack.empty())
+    return;
+  auto  f    = stack.back();
+  auto  dt   = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now()-f.start).count());
+  auto& s    = stat[f.sym];
+  stack.pop_back();
+
+  s.calls++;
+  s.depth--;
+  if(s.depth==0)
+    s.inclusive += dt;
+  s.exclusive += (dt>f.child ? dt-f.child : 0);
+  if(!stack.empty())
+    stack.back().child += dt;
+  }
+
+std::vector<size_t> ScriptProfiler::sorted() const {
+  std::vector<size_t> ret;
+  for(size_t i=0; i<stat.size(); ++i)
+    if(stat[i].calls>0)
+      ret.push_back(i);
+  std::sort(ret.begin(),ret.end(),[this](size_t l, size_t r){
+    return stat[l].exclusive>stat[r].exclusive;
+    });
+  return ret;
+  }
+
+void ScriptProfiler::format(char* buf, size_t bufSz, size_t sym) const {
+  auto& s    = stat[sym];
+  auto& name = vm.getDATFile().getSymbolByIndex(sym).name;
+  std::snprintf(buf,bufSz,"%-40s calls: %8llu incl: %9.3fms excl: %9.3fms",
+                name.c_str(), static_cast<unsigned long long>(s.calls),
+                double(s.inclusive)/1000000.0, double(s.exclusive)/1000000.0);
+  }
+
+void ScriptProfiler::report(size_t topN, const std::function<void(std::string_view)>& out) const {
+  auto ord = sorted();
+  if(ord.size()>topN)
+    ord.resize(topN);
+  for(auto i:ord) {
+    char buf[256]={};
+    format(buf,sizeof(buf),i);
+    out(buf);
+    }
+  }
+
+bool ScriptProfiler::dump(const std::string& path) const {
+  std::ofstream fout(path);
+  if(!fout.is_open()) {
+    Log::e("unable to write script profile: \"",path,"\"");
+    return false;
+    }
+  fout << "name;calls;inclusive_ns;exclusive_ns" << std::endl;
+  for(auto i:sorted()) {
+    auto& s = stat[i];
+    fout << vm.getDATFile().getSymbolByIndex(i).name << ";" << s.calls << ";" << s.inclusive << ";" << s.exclusive << std::endl;
+    }
+  return true;
+  }
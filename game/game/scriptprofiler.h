@@ -0,0 +1,61 @@
+#pragma once
+
+#include <daedalus/DaedalusVM.h>
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+
+class ScriptProfiler final {
+  public:
+    ScriptProfiler(Daedalus::DaedalusVM& vm);
+
+    class Scope final {
+      public:
+        Scope(ScriptProfiler& owner, size_t sym):owner(owner.enabled ? &owner : nullptr) {
+          if(this->owner!=nullptr && !this->owner->enter(sym))
+            this->owner = nullptr;
+          }
+        Scope(const Scope&)=delete;
+        ~Scope() {
+          if(owner!=nullptr)
+            owner->leave();
+          }
+      private:
+        ScriptProfiler* owner = nullptr;
+      };
+
+    bool isEnabled() const { return enabled; }
+    void setEnabled(bool e);
+    void reset();
+
+    void report(size_t topN, const std::function<void(std::string_view)>& out) const;
+    bool dump(const std::string& path) const;
+
+  private:
+    using clock = std::chrono::steady_clock;
+
+    struct Stat final {
+      uint64_t calls     = 0;
+      uint64_t inclusive = 0;
+      uint64_t exclusive = 0;
+      uint32_t depth     = 0; // recursion depth, to not count inclusive time twice
+      };
+
+    struct Frame final {
+      size_t            sym   = 0;
+      clock::time_point start;
+      uint64_t          child = 0;
+      };
+
+    bool enter(size_t sym);
+    void leave();
+    auto sorted() const -> std::vector<size_t>;
+    void format(char* buf, size_t bufSz, size_t sym) const;
+
+    Daedalus::DaedalusVM& vm;
+    bool                  enabled = false;
+    std::vector<Stat>     stat;
+    std::vector<Frame>    stack;
+  };
@@ -0,0 +1,132 @@
+#include "symbolindex.h"
+
+#include <Tempest/Log>
+#include <algorithm>
+
+using namespace Tempest;
+
+static char upper(char c) {
+  if('a'<=c && c<='z')
+    return char((c-'a')+'A');
+  return c;
+  }
+
+static uint64_t mix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33;
+  return h;
+  }
+
+void SymbolIndex::build(const std::vector<Daedalus::PARSymbol>& symbols) {
+  for(uint64_t s=0; s<8; ++s) {
+    if(implBuild(symbols,s))
+      return;
+    }
+  // practically unreachable: caller falls back to ZenLib lookup
+  Log::e("SymbolIndex: unable to build perfect hash for ",symbols.size()," symbols");
+  disp.clear();
+  slot.clear();
+  names.clear();
+  }
+
+size_t SymbolIndex::find(std::string_view name) const {
+  if(slot.empty())
+    return size_t(-1);
+
+  const uint64_t h = hash(name);
+  const auto&    s = slot[slotId(h,disp[h%disp.size()])];
+  if(s.symbol==uint32_t(-1) || s.nameLen!=name.size())
+    return size_t(-1);
+
+  const char* str = names.data()+s.nameOff;
+  for(size_t i=0; i<name.size(); ++i)
+    if(str[i]!=upper(name[i]))
+      return size_t(-1);
+  return s.symbol;
+  }
+
+bool SymbolIndex::implBuild(const std::vector<Daedalus::PARSymbol>& symbols, uint64_t sd) {
+  seed = sd;
+
+  const size_t cnt = symbols.size();
+  std::vector<uint64_t> hv(cnt);
+  for(size_t i=0; i<cnt; ++i)
+    hv[i] = hash(symbols[i].name);
+
+  // ~4 keys per bucket, 80% table load: builds fast and stays compact
+  disp.assign(cnt/4+1,0);
+  slot.assign(cnt+cnt/4+1,Slot());
+  names.clear();
+
+  std::vector<std::vector<uint32_t>> bucket(disp.size());
+  for(size_t i=0; i<cnt; ++i)
+    bucket[hv[i]%disp.size()].push_back(uint32_t(i));
+
+  std::vector<uint32_t> order(bucket.size());
+  for(size_t i=0; i<order.size(); ++i)
+    order[i] = uint32_t(i);
+  std::sort(order.begin(),order.end(),[&bucket](uint32_t l, uint32_t r){
+    return bucket[l].size()>bucket[r].size();
+    });
+
+  std::vector<size_t> taken;
+  for(auto b:order) {
+    auto& keys = bucket[b];
+    if(keys.empty())
+      break;
+
+    // duplicated names: keep the first symbol
+    for(size_t i=0; i<keys.size(); ++i) {
+      for(size_t r=i+1; r<keys.size();) {
+        if(hv[keys[i]]==hv[keys[r]] && symbols[keys[i]].name==symbols[keys[r]].name)
+          keys.erase(keys.begin()+int(r)); else
+          ++r;
+        }
+      }
+
+    bool placed = false;
+    for(uint32_t d=0; d<(1u<<16) && !placed; ++d) {
+      taken.clear();
+      placed = true;
+      for(auto k:keys) {
+        size_t id = slotId(hv[k],d);
+        if(slot[id].symbol!=uint32_t(-1) || std::find(taken.begin(),taken.end(),id)!=taken.end()) {
+          placed = false;
+          break;
+          }
+        taken.push_back(id);
+        }
+      if(placed)
+        disp[b] = d;
+      }
+    if(!placed)
+      return false;
+
+    for(size_t i=0; i<keys.size(); ++i) {
+      auto& name = symbols[keys[i]].name;
+      auto& s    = slot[taken[i]];
+      s.symbol  = keys[i];
+      s.nameOff = uint32_t(names.size());
+      s.nameLen = uint32_t(name.size());
+      for(auto c:name)
+        names.push_back(upper(c));
+      }
+    }
+  return true;
+  }
+
+uint64_t SymbolIndex::hash(std::string_view name) const {
+  uint64_t h = 0xcbf29ce484222325ull ^ (seed*0x9e3779b97f4a7c15ull);
+  for(auto c:name) {
+    h ^= uint8_t(upper(c));
+    h *= 0x100000001b3ull;
+    }
+  return h;
+  }
+
+size_t SymbolIndex::slotId(uint64_t h, uint32_t d) const {
+  return size_t(mix(h + d*0x9e3779b97f4a7c15ull) % slot.size());
+  }
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <daedalus/DaedalusVM.h>
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+// perfect-hash (hash and displace) index over Daedalus symbol names; case-insensitive
+class SymbolIndex final {
+  public:
+    SymbolIndex() = default;
+
+    void   build(const std::vector<Daedalus::PARSymbol>& symbols);
+    size_t find (std::string_view name) const;
+    bool   isEmpty() const { return slot.empty(); }
+
+  private:
+    struct Slot final {
+      uint32_t symbol  = uint32_t(-1);
+      uint32_t nameOff = 0;
+      uint32_t nameLen = 0;
+      };
+
+    bool     implBuild(const std::vector<Daedalus::PARSymbol>& symbols, uint64_t seed);
+    uint64_t hash(std::string_view name) const;
+    size_t   slotId(uint64_t h, uint32_t disp) const;
+
+    uint64_t              seed = 0;
+    std::vector<uint32_t> disp;
+    std::vector<Slot>     slot;
+    std::vector<char>     names;
+  };
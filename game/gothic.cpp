@@ -389,6 +389,7 @@ void Gothic::startLoad(std::string_view banner,
 void Gothic::implStartLoadSave(std::string_view banner,
                                bool load,
                                const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f) {
+  Resources::PinScope pin;
   loadTex = banner.empty() ? &saveTex : Resources::loadTexture(banner);
   loadProgress.store(0);
 
@@ -398,6 +399,8 @@ void Gothic::implStartLoadSave(std::string_view banner,
     return; // loading already
     }
 
+  if(load)
+    Resources::beginWorldLoad();
   onStartLoading();
   auto g = clearGame().release();
   try{
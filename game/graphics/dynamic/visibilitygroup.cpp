@@ -60,6 +60,12 @@ const Bounds& VisibilityGroup::Token::bounds() const {
   return owner->tokens[id].bbox;
   }
 
+bool VisibilityGroup::Token::isVisible() const {
+  if(owner==nullptr)
+    return false;
+  return owner->tokens[id].visible;
+  }
+
 VisibilityGroup::VisibilityGroup() {
   freeList.reserve(4);
   }
@@ -96,6 +102,7 @@ void VisibilityGroup::pass(const Frustrum f[]) {
       }
 
     if(t.alwaysVis) {
+      t.visible = true;
       t.vSet->push(t.id,SceneGlobals::V_Shadow0);
       t.vSet->push(t.id,SceneGlobals::V_Shadow1);
       t.vSet->push(t.id,SceneGlobals::V_Main);
@@ -116,6 +123,7 @@ void VisibilityGroup::pass(const Frustrum f[]) {
         t.vSet->push(t.id,SceneGlobals::V_Shadow1);
       if(visible[SceneGlobals::V_Main])
         t.vSet->push(t.id,SceneGlobals::V_Main);
+      t.visible = visible[SceneGlobals::V_Shadow0] || visible[SceneGlobals::V_Shadow1] || visible[SceneGlobals::V_Main];
       }
 
     });
@@ -88,11 +88,19 @@ bool MdlVisual::hasOverlay(const Skeleton* sk) const {
   return solver.hasOverlay(sk);
   }
 
+bool MdlVisual::hasOverlay(std::string_view sk) const {
+  return solver.hasOverlay(sk);
+  }
+
 // Mdl_ApplyOverlayMdsTimed, Mdl_ApplyOverlayMds
 void MdlVisual::addOverlay(const Skeleton *sk, uint64_t time) {
   solver.addOverlay(sk,time);
   }
 
+void MdlVisual::addOverlay(std::string_view sk, uint64_t time) {
+  solver.addOverlay(sk,time);
+  }
+
 // Mdl_RemoveOverlayMDS
 void MdlVisual::delOverlay(std::string_view sk) {
   solver.delOverlay(sk);
@@ -479,13 +487,36 @@ bool MdlVisual::updateAnimation(Npc* npc, World& world, uint64_t dt) {
     }
 
   solver.update(tickCount);
+  if(npc!=nullptr && !isPoseUpdateDue(*npc,world,pos3,tickCount))
+    return false;
+
   const bool changed = pose.update(tickCount);
+  poseUpdate = tickCount;
 
   if(changed)
     view.setPose(pos,pose);
   return changed;
   }
 
+bool MdlVisual::isPoseUpdateDue(const Npc& npc, const World& world, const Vec3& at, uint64_t tickCount) const {
+  // animation LOD: time-line and root motion are time based, so only skeleton evaluation is skipped
+  static const float    nearDist = 2000, farDist = 5000;
+  static const uint64_t midRate  = 33,   farRate = 100;
+
+  auto pl = world.player();
+  if(pl==nullptr || pl==&npc || poseUpdate==0)
+    return true;
+  const float qDist = (at-pl->position()).quadLength();
+  if(!view.isVisible()) {
+    // bones of close npc are still used by gameplay (weapon hits, item attachments)
+    return qDist<nearDist*nearDist && tickCount>=poseUpdate+farRate;
+    }
+  if(qDist<nearDist*nearDist)
+    return true;
+  const uint64_t rate = qDist<farDist*farDist ? midRate : farRate;
+  return tickCount>=poseUpdate+rate;
+  }
+
 void MdlVisual::processLayers(World& world) {
   Pose&    pose      = *skInst;
   uint64_t tickCount = world.tickCount();
@@ -40,7 +40,9 @@ class MdlVisual final {
     const Skeleton*                visualSkeleton() const;
 
     bool                           hasOverlay(const Skeleton*  sk) const;
+    bool                           hasOverlay(std::string_view sk) const;
     void                           addOverlay(const Skeleton*  sk, uint64_t time);
+    void                           addOverlay(std::string_view sk, uint64_t time);
     void                           delOverlay(std::string_view sk);
     void                           delOverlay(const Skeleton*  sk);
     void                           clearOverlays();
@@ -146,6 +148,8 @@ class MdlVisual final {
     void rebindAttaches(Attach<View>& mesh, const Skeleton& to);
     void rebindAttaches(const Skeleton& to);
 
+    bool isPoseUpdateDue(const Npc& npc, const World& world, const Tempest::Vec3& at, uint64_t tickCount) const;
+
     Tempest::Matrix4x4             pos;
     MeshObjects::Mesh              view;
 
@@ -168,5 +172,6 @@ class MdlVisual final {
     WeaponState                    fgtMode=WeaponState::NoWeapon;
     AnimationSolver                solver;
     std::unique_ptr<Pose>          skInst;
+    uint64_t                       poseUpdate=0;
   };
 
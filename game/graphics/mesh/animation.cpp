@@ -2,6 +2,9 @@
 
 #include <Tempest/Log>
 #include <cctype>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
 
 #include <zenload/modelAnimationParser.h>
 #include <zenload/zCModelPrototype.h>
@@ -12,6 +15,7 @@
 #include "world/world.h"
 #include "utils/fileext.h"
 #include "resources.h"
+#include "animmath.h"
 
 using namespace Tempest;
 
@@ -240,9 +244,23 @@ Animation::Sequence& Animation::loadMAN(const std::string& name) {
   return ret;
   }
 
+size_t Animation::memoryUsage() const {
+  size_t ret = 0;
+  for(auto& s:sequences) {
+    if(s.data==nullptr)
+      continue;
+    auto& d = *s.data;
+    ret += d.packed.size()*sizeof(uint16_t) + d.constSmp.size()*sizeof(float) +
+           d.tr.size()*sizeof(Tempest::Vec3) + d.nodeIndex.size()*sizeof(uint32_t);
+    }
+  return ret;
+  }
+
 void Animation::setupIndex() {
-  for(auto& sq:sequences)
+  for(auto& sq:sequences) {
     sq.data->setupEvents(sq.data->fpsRate);
+    sq.data->setupTimeline();
+    }
 
   for(auto& r:ref) {
     Sequence ani;
@@ -335,7 +353,7 @@ Animation::Sequence::Sequence(const std::string &fname) {
         }
       case ZenLoad::ModelAnimationParser::CHUNK_RAWDATA:
         data->nodeIndex = std::move(p.getNodeIndex());
-        data->samples   = p.getSamples();
+        data->setupSamples(p.getSamples());
         break;
       case ZenLoad::ModelAnimationParser::CHUNK_ERROR:
         throw std::runtime_error("animation load error");
@@ -447,25 +465,50 @@ bool Animation::Sequence::extractFrames(uint64_t& frameA,uint64_t& frameB,bool&
   return true;
   }
 
+template<class F>
+void Animation::Sequence::forEachEvent(uint64_t frameA, uint64_t frameB, bool invert, F fn) const {
+  auto& tl = data->timeline;
+  auto  lb = [&tl](uint64_t fr) {
+    return std::lower_bound(tl.begin(),tl.end(),fr,[](const AnimData::EvKey& k, uint64_t f){
+      return k.frame<f;
+      });
+    };
+
+  if(!invert) {
+    for(auto i=lb(frameA), e=lb(frameB); i!=e; ++i)
+      fn(*i);
+    } else {
+    // wrapped around loop end: [0,frameA) + [frameB,end)
+    for(auto i=tl.begin(), e=lb(frameA); i!=e; ++i)
+      fn(*i);
+    for(auto i=lb(frameB); i!=tl.end(); ++i)
+      fn(*i);
+    }
+  }
+
 void Animation::Sequence::processSfx(uint64_t barrier, uint64_t sTime, uint64_t now, Npc& npc) const {
   uint64_t frameA=0,frameB=0;
   bool     invert=false;
   if(!extractFrames(frameA,frameB,invert,barrier,sTime,now))
     return;
 
-  auto& d = *data;
-  for(auto& i:d.sfx) {
-    uint64_t fr = frameClamp(i.m_Frame,d.firstFrame,d.numFrames,d.lastFrame);
-    if(((frameA<=fr && fr<frameB) ^ invert) ||
-       i.m_Frame==int32_t(d.lastFrame))
+  auto&      d      = *data;
+  const bool ground = !npc.isInAir();
+  forEachEvent(frameA,frameB,invert,[&](const AnimData::EvKey& k) {
+    if(k.type==AnimData::EvSfx) {
+      auto& i = d.sfx[k.id];
       npc.emitSoundEffect(i.m_Name,i.m_Range,i.m_EmptySlot);
-    }
-  if(!npc.isInAir()) {
-    for(auto& i:d.gfx){
-      uint64_t fr = frameClamp(i.m_Frame,d.firstFrame,d.numFrames,d.lastFrame);
-      if((frameA<=fr && fr<frameB) ^ invert)
-        npc.emitSoundGround(i.m_Name,i.m_Range,i.m_EmptySlot);
       }
+    else if(k.type==AnimData::EvGfx && ground) {
+      auto& i = d.gfx[k.id];
+      npc.emitSoundGround(i.m_Name,i.m_Range,i.m_EmptySlot);
+      }
+    });
+  for(auto& k:d.evLast) {
+    if(k.type!=AnimData::EvSfx)
+      continue;
+    auto& i = d.sfx[k.id];
+    npc.emitSoundEffect(i.m_Name,i.m_Range,i.m_EmptySlot);
     }
   }
 
@@ -475,25 +518,23 @@ void Animation::Sequence::processPfx(uint64_t barrier, uint64_t sTime, uint64_t
   if(!extractFrames(frameA,frameB,invert,barrier,sTime,now))
     return;
 
-  auto& d = *data;
-  for(auto& i:d.pfx){
-    uint64_t fr = frameClamp(i.m_Frame,d.firstFrame,d.numFrames,d.lastFrame);
-    if(((frameA<=fr && fr<frameB) ^ invert) ||
-       i.m_Frame==int32_t(d.lastFrame)) {
+  auto& d  = *data;
+  auto  fn = [&](const AnimData::EvKey& k) {
+    if(k.type==AnimData::EvPfx) {
+      auto& i = d.pfx[k.id];
       if(i.m_Name.empty())
-        continue;
+        return;
       Effect e(PfxEmitter(world,i.m_Name),i.m_Pos);
       e.setActive(true);
       visual.startEffect(world,std::move(e),i.m_Num,false);
       }
-    }
-  for(auto& i:d.pfxStop){
-    uint64_t fr = frameClamp(i.m_Frame,d.firstFrame,d.numFrames,d.lastFrame);
-    if(((frameA<=fr && fr<frameB) ^ invert) ||
-       i.m_Frame==int32_t(d.lastFrame)) {
-      visual.stopEffect(i.m_Num);
+    else if(k.type==AnimData::EvPfxStop) {
+      visual.stopEffect(d.pfxStop[k.id].m_Num);
       }
-    }
+    };
+  forEachEvent(frameA,frameB,invert,fn);
+  for(auto& k:d.evLast)
+    fn(k);
   }
 
 void Animation::Sequence::processEvents(uint64_t barrier, uint64_t sTime, uint64_t now, EvCount& ev) const {
@@ -505,35 +546,26 @@ void Animation::Sequence::processEvents(uint64_t barrier, uint64_t sTime, uint64
   auto& d       = *data;
   float fpsRate = d.fpsRate;
 
-  for(auto& e:d.events) {
-    if(e.m_Def==ZenLoad::DEF_OPT_FRAME) {
-      for(auto i:e.m_Int){
-        uint64_t fr = frameClamp(i,d.firstFrame,d.numFrames,d.lastFrame);
-        if((frameA<=fr && fr<frameB) ^ invert)
-          processEvent(e,ev,uint64_t(float(fr)*1000.f/fpsRate)+sTime);
+  forEachEvent(frameA,frameB,invert,[&](const AnimData::EvKey& k) {
+    switch(k.type) {
+      case AnimData::EvEvent:
+        processEvent(d.events[k.id],ev,uint64_t(float(k.frame)*1000.f/fpsRate)+sTime);
+        break;
+      case AnimData::EvGfx:
+        ev.groundSounds++;
+        break;
+      case AnimData::EvMMStartAni: {
+        auto&   i = d.mmStartAni[k.id];
+        EvMorph e;
+        e.anim = i.m_Animation.c_str();
+        e.node = i.m_Node.c_str();
+        ev.morph.push_back(e);
+        break;
         }
-      } else {
-      uint64_t fr = frameClamp(e.m_Frame,d.firstFrame,d.numFrames,d.lastFrame);
-      if((frameA<=fr && fr<frameB) ^ invert)
-        processEvent(e,ev,uint64_t(float(fr)*1000.f/fpsRate)+sTime);
-      }
-    }
-
-  for(auto& i:d.gfx){
-    uint64_t fr = frameClamp(i.m_Frame,d.firstFrame,d.numFrames,d.lastFrame);
-    if((frameA<=fr && fr<frameB) ^ invert)
-      ev.groundSounds++;
-    }
-
-  for(auto& i:d.mmStartAni){
-    uint64_t fr = frameClamp(i.m_Frame,d.firstFrame,d.numFrames,d.lastFrame);
-    if((frameA<=fr && fr<frameB) ^ invert) {
-      EvMorph e;
-      e.anim = i.m_Animation.c_str();
-      e.node = i.m_Node.c_str();
-      ev.morph.push_back(e);
+      default:
+        break;
       }
-    }
+    });
   }
 
 void Animation::Sequence::processEvent(const ZenLoad::zCModelEvent &e, Animation::EvCount &ev, uint64_t time) {
@@ -675,40 +707,205 @@ void Animation::Sequence::setupMoveTr() {
   data->setupMoveTr();
   }
 
-void Animation::AnimData::setupMoveTr() {
-  size_t sz = nodeIndex.size();
-
-  if(samples.size()>0 && samples.size()>=sz) {
-    auto& a = samples[0].position;
-    auto& b = samples[samples.size()-sz].position;
-    moveTr.x = b.x-a.x;
-    moveTr.y = b.y-a.y;
-    moveTr.z = b.z-a.z;
-
-    tr.resize(samples.size()/sz);
-    for(size_t i=0,r=0;i<samples.size();i+=sz,++r){
-      auto& p  = tr[r];
-      auto& bi = samples[i].position;
-      p.x = bi.x-a.x;
-      p.y = bi.y-a.y;
-      p.z = bi.z-a.z;
+static const float quatRange = 0.70710678f; // smallest-three components are within [-1/sqrt(2), 1/sqrt(2)]
+
+static uint16_t quantize(float v, float min, float ext, uint32_t maxV) {
+  if(ext<=0.f)
+    return 0;
+  float k = std::max(0.f,std::min(1.f,(v-min)/ext));
+  return uint16_t(std::lround(k*float(maxV)));
+  }
+
+static float dequantize(uint16_t v, float min, float ext, uint32_t maxV) {
+  return min + float(v)*ext/float(maxV);
+  }
+
+static void packQuat(const ZMath::float4& src, uint16_t* dst) {
+  float q[4] = {src.x,src.y,src.z,src.w};
+  float len  = std::sqrt(q[0]*q[0]+q[1]*q[1]+q[2]*q[2]+q[3]*q[3]);
+  int   mx   = 0;
+  for(int i=0; i<4; ++i) {
+    q[i] = len>0 ? q[i]/len : (i==3 ? 1.f : 0.f);
+    if(std::fabs(q[i])>std::fabs(q[mx]))
+      mx = i;
+    }
+  // q and -q are same rotation: make largest component positive
+  const float sgn = q[mx]<0 ? -1.f : 1.f;
+  for(int i=0, r=0; i<4; ++i) {
+    if(i==mx)
+      continue;
+    dst[r] = quantize(q[i]*sgn,-quatRange,2.f*quatRange,0x7FFF);
+    ++r;
+    }
+  dst[0] = uint16_t(dst[0] | ((mx&0x1)<<15));
+  dst[1] = uint16_t(dst[1] | ((mx&0x2)<<14));
+  }
+
+static void unpackQuat(const uint16_t* src, float* q) {
+  const int mx  = (src[0]>>15) | ((src[1]>>15)<<1);
+  float     sum = 0;
+  for(int i=0, r=0; i<4; ++i) {
+    if(i==mx)
+      continue;
+    q[i] = dequantize(uint16_t(src[r]&0x7FFF),-quatRange,2.f*quatRange,0x7FFF);
+    sum += q[i]*q[i];
+    ++r;
+    }
+  q[mx] = std::sqrt(std::max(0.f,1.f-sum));
+  }
+
+void Animation::AnimData::setupSamples(const std::vector<ZenLoad::zCModelAniSample>& smp) {
+  const size_t sz = nodeIndex.size();
+  if(sz==0 || smp.size()%sz!=0)
+    return;
+
+  sampleFrames = smp.size()/sz;
+  stride       = soaStride(sz);
+  constSmp.resize(SmpRows*stride);
+  toSoA(constSmp.data(),stride,smp.data(),sz);
+
+  static const float rotEps = 1e-5f, posEps = 1e-3f;
+  for(size_t i=0; i<sz; ++i) {
+    auto& q0 = smp[i].rotation;
+    auto& p0 = smp[i].position;
+    bool  cRot = true, cPos = true;
+    Tempest::Vec3 min = {p0.x,p0.y,p0.z}, max = min;
+    for(size_t f=1; f<sampleFrames; ++f) {
+      auto& q = smp[f*sz+i].rotation;
+      auto& p = smp[f*sz+i].position;
+      if(std::fabs(q.x-q0.x)>rotEps || std::fabs(q.y-q0.y)>rotEps || std::fabs(q.z-q0.z)>rotEps || std::fabs(q.w-q0.w)>rotEps)
+        cRot = false;
+      if(std::fabs(p.x-p0.x)>posEps || std::fabs(p.y-p0.y)>posEps || std::fabs(p.z-p0.z)>posEps)
+        cPos = false;
+      min.x = std::min(min.x,p.x); max.x = std::max(max.x,p.x);
+      min.y = std::min(min.y,p.y); max.y = std::max(max.y,p.y);
+      min.z = std::min(min.z,p.z); max.z = std::max(max.z,p.z);
       }
-    static const float eps = 0.4f;
-    for(auto& i:tr) {
-      if(std::fabs(i.x)<eps && std::fabs(i.y)<eps && std::fabs(i.z)<eps)
-        continue;
-      hasMoveTr = true;
-      break;
+    if(!cRot)
+      rotTrack.push_back(uint16_t(i));
+    if(!cPos) {
+      posTrack.push_back(uint16_t(i));
+      posMin.push_back(min);
+      posExt.push_back(max-min);
+      }
+    }
+
+  const size_t frameSz = (rotTrack.size()+posTrack.size())*3;
+  packed.resize(sampleFrames*frameSz);
+  for(size_t f=0; f<sampleFrames; ++f) {
+    uint16_t* dst = &packed[f*frameSz];
+    for(auto i:rotTrack) {
+      packQuat(smp[f*sz+i].rotation,dst);
+      dst+=3;
+      }
+    for(size_t r=0; r<posTrack.size(); ++r) {
+      auto& p = smp[f*sz+posTrack[r]].position;
+      dst[0] = quantize(p.x,posMin[r].x,posExt[r].x,0xFFFF);
+      dst[1] = quantize(p.y,posMin[r].y,posExt[r].y,0xFFFF);
+      dst[2] = quantize(p.z,posMin[r].z,posExt[r].z,0xFFFF);
+      dst+=3;
       }
     }
+  }
 
-  if(samples.size()>0){
-    translate.x = samples[0].position.x;
-    translate.y = samples[0].position.y;
-    translate.z = samples[0].position.z;
+void Animation::AnimData::decodeFrame(size_t frame, float* dst) const {
+  std::memcpy(dst,constSmp.data(),constSmp.size()*sizeof(float));
+
+  const size_t    frameSz = (rotTrack.size()+posTrack.size())*3;
+  const uint16_t* src     = &packed[frame*frameSz];
+  for(auto i:rotTrack) {
+    float q[4];
+    unpackQuat(src,q);
+    dst[SmpQx*stride+i] = q[0];
+    dst[SmpQy*stride+i] = q[1];
+    dst[SmpQz*stride+i] = q[2];
+    dst[SmpQw*stride+i] = q[3];
+    src+=3;
+    }
+  for(size_t r=0; r<posTrack.size(); ++r) {
+    const size_t i = posTrack[r];
+    dst[SmpPx*stride+i] = dequantize(src[0],posMin[r].x,posExt[r].x,0xFFFF);
+    dst[SmpPy*stride+i] = dequantize(src[1],posMin[r].y,posExt[r].y,0xFFFF);
+    dst[SmpPz*stride+i] = dequantize(src[2],posMin[r].z,posExt[r].z,0xFFFF);
+    src+=3;
     }
   }
 
+Tempest::Vec3 Animation::AnimData::position(size_t frame, size_t track) const {
+  for(size_t r=0; r<posTrack.size(); ++r) {
+    if(posTrack[r]!=track)
+      continue;
+    const size_t    frameSz = (rotTrack.size()+posTrack.size())*3;
+    const uint16_t* src     = &packed[frame*frameSz + (rotTrack.size()+r)*3];
+    return Tempest::Vec3(dequantize(src[0],posMin[r].x,posExt[r].x,0xFFFF),
+                         dequantize(src[1],posMin[r].y,posExt[r].y,0xFFFF),
+                         dequantize(src[2],posMin[r].z,posExt[r].z,0xFFFF));
+    }
+  return Tempest::Vec3(constSmp[SmpPx*stride+track],constSmp[SmpPy*stride+track],constSmp[SmpPz*stride+track]);
+  }
+
+void Animation::AnimData::setupMoveTr() {
+  if(sampleFrames==0)
+    return;
+
+  const size_t frames = sampleFrames;
+  const auto   a      = position(0,0);
+  moveTr = position(frames-1,0)-a;
+
+  tr.resize(frames);
+  for(size_t r=0; r<frames; ++r)
+    tr[r] = position(r,0)-a;
+
+  static const float eps = 0.4f;
+  for(auto& i:tr) {
+    if(std::fabs(i.x)<eps && std::fabs(i.y)<eps && std::fabs(i.z)<eps)
+      continue;
+    hasMoveTr = true;
+    break;
+    }
+
+  translate = a;
+  }
+
+void Animation::AnimData::setupTimeline() {
+  timeline.clear();
+  evLast.clear();
+
+  auto push = [this](EvType type, size_t id, int32_t frame, bool onLast) {
+    EvKey k;
+    k.frame = uint32_t(frameClamp(frame,firstFrame,numFrames,lastFrame));
+    k.type  = type;
+    k.id    = uint32_t(id);
+    if(onLast && frame==int32_t(lastFrame))
+      evLast.push_back(k); else
+      timeline.push_back(k);
+    };
+
+  for(size_t i=0; i<sfx.size(); ++i)
+    push(EvSfx,i,sfx[i].m_Frame,true);
+  for(size_t i=0; i<gfx.size(); ++i)
+    push(EvGfx,i,gfx[i].m_Frame,false);
+  for(size_t i=0; i<pfx.size(); ++i)
+    push(EvPfx,i,pfx[i].m_Frame,true);
+  for(size_t i=0; i<pfxStop.size(); ++i)
+    push(EvPfxStop,i,pfxStop[i].m_Frame,true);
+  for(size_t i=0; i<events.size(); ++i) {
+    auto& e = events[i];
+    if(e.m_Def==ZenLoad::DEF_OPT_FRAME) {
+      for(auto fr:e.m_Int)
+        push(EvEvent,i,fr,false);
+      } else {
+      push(EvEvent,i,e.m_Frame,false);
+      }
+    }
+  for(size_t i=0; i<mmStartAni.size(); ++i)
+    push(EvMMStartAni,i,mmStartAni[i].m_Frame,false);
+
+  std::stable_sort(timeline.begin(),timeline.end(),[](const EvKey& l, const EvKey& r){
+    return l.frame<r.frame;
+    });
+  }
+
 void Animation::AnimData::setupEvents(float fpsRate) {
   if(fpsRate<=0.f)
     return;
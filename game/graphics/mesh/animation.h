@@ -46,10 +46,32 @@ class Animation final {
       };
 
     struct AnimData final {
+      enum EvType : uint8_t {
+        EvSfx,
+        EvGfx,
+        EvPfx,
+        EvPfxStop,
+        EvEvent,
+        EvMMStartAni,
+        };
+
+      struct EvKey final {
+        uint32_t frame = 0; // clamped, relative to firstFrame
+        EvType   type  = EvSfx;
+        uint32_t id    = 0; // index in sfx, gfx, pfx, pfxStop, events or mmStartAni
+        };
+
       Tempest::Vec3                               translate={};
       Tempest::Vec3                               moveTr={};
 
-      std::vector<ZenLoad::zCModelAniSample>      samples;
+      // compressed samples: constant tracks are stored once (as SoA frame, see SampleRow),
+      // animated ones per frame - rotation as smallest-three, position as 16 bit in [posMin,posMin+posExt]
+      std::vector<float>                          constSmp;
+      std::vector<uint16_t>                       rotTrack, posTrack;
+      std::vector<Tempest::Vec3>                  posMin, posExt;
+      std::vector<uint16_t>                       packed;
+      size_t                                      stride=0;
+      size_t                                      sampleFrames=0;
       std::vector<uint32_t>                       nodeIndex;
       std::vector<Tempest::Vec3>                  tr;
       bool                                        hasMoveTr=false;
@@ -67,12 +89,19 @@ class Animation final {
 
       std::vector<ZenLoad::zCModelScriptEventMMStartAni> mmStartAni;
 
+      std::vector<EvKey>                          timeline;    // all frame events, sorted by frame
+      std::vector<EvKey>                          evLast;      // sfx/pfx bound to last frame: fired on every step
+
       std::vector<uint64_t>                       defHitEnd;   // hit-end time
       std::vector<uint64_t>                       defParFrame;
       std::vector<uint64_t>                       defWindow;
 
+      void                                        setupSamples(const std::vector<ZenLoad::zCModelAniSample>& smp);
+      void                                        decodeFrame(size_t frame, float* dst) const;
+      Tempest::Vec3                               position(size_t frame, size_t track) const;
       void                                        setupMoveTr();
       void                                        setupEvents(float fpsRate);
+      void                                        setupTimeline();
       };
 
     struct Sequence final {
@@ -120,6 +149,8 @@ class Animation final {
         void                                 setupMoveTr();
         static void                          processEvent(const ZenLoad::zCModelEvent& e, EvCount& ev, uint64_t time);
         bool                                 extractFrames(uint64_t &frameA, uint64_t &frameB, bool &invert, uint64_t barrier, uint64_t sTime, uint64_t now) const;
+        template<class F>
+        void                                 forEachEvent(uint64_t frameA, uint64_t frameB, bool invert, F fn) const;
       };
 
     struct MeshAndThree {
@@ -133,6 +164,7 @@ class Animation final {
     const Sequence*    sequenceAsc(std::string_view name) const;
     void               debug() const;
     const std::string& defaultMesh() const;
+    size_t             memoryUsage() const;
 
   private:
     Sequence& loadMAN(const std::string &name);
@@ -8,16 +8,59 @@
 #include "pose.h"
 #include "resources.h"
 
+#include <algorithm>
+#include <map>
+#include <mutex>
+
 using namespace Tempest;
 
+static constexpr int WeaponCount = int(WeaponState::Mage)+1;
+static constexpr int WalkCount   = 6;
+
+// walk-modes, as seen by animation selection; ordered by priority
+static const WalkBit walkClassBits[WalkCount] = {
+  WalkBit::WM_Run, WalkBit::WM_Water, WalkBit::WM_Walk, WalkBit::WM_Sneak, WalkBit::WM_Swim, WalkBit::WM_Dive
+  };
+
+static int walkClass(WalkBit wlk) {
+  for(int i=WalkCount-1; i>0; --i)
+    if(bool(wlk & walkClassBits[i]))
+      return i;
+  return 0;
+  }
+
+static bool isPoseDependent(AnimationSolver::Anim a, WalkBit wlk) {
+  switch(a) {
+    case AnimationSolver::Atack:
+    case AnimationSolver::AtackBlock:
+    case AnimationSolver::AimBow:
+    case AnimationSolver::JumpHang:
+    case AnimationSolver::DeadA:
+    case AnimationSolver::DeadB:
+      return true;
+    case AnimationSolver::Move:
+      return bool(wlk & WalkBit::WM_Dive);
+    default:
+      return false;
+    }
+  }
+
+struct AnimationSolver::Table final {
+  const Animation::Sequence* anim[AnimLast+1][WeaponCount][WalkCount] = {};
+  const Animation::Sequence* draw[WeaponCount][WeaponCount][2]       = {};
+  };
+
 AnimationSolver::AnimationSolver() {
   }
 
 void AnimationSolver::save(Serialize &fout) const {
-  fout.write(uint32_t(overlay.size()));
+  fout.write(uint32_t(overlay.size()+pending.size()));
   for(auto& i:overlay){
     fout.write(i.skeleton->name(),i.time);
     }
+  for(auto& i:pending){
+    fout.write(i.name,i.time);
+    }
   }
 
 void AnimationSolver::load(Serialize &fin) {
@@ -38,6 +81,7 @@ void AnimationSolver::load(Serialize &fin) {
       ++sz;
     }
   overlay.resize(sz);
+  pending.clear();
   invalidateCache();
   }
 
@@ -50,9 +94,22 @@ bool AnimationSolver::hasOverlay(const Skeleton* sk) const {
   for(auto& i:overlay)
     if(i.skeleton==sk)
       return true;
+  for(auto& i:pending)
+    if(isReady(i) && i.skeleton.get()==sk)
+      return true;
   return false;
   }
 
+bool AnimationSolver::hasOverlay(std::string_view sk) const {
+  // pending overlay is matched by name, so engine code sees it right after add
+  for(auto& i:pending)
+    if(i.name==sk)
+      return true;
+  if(overlay.size()==0)
+    return false;
+  return hasOverlay(Resources::loadSkeleton(sk));
+  }
+
 void AnimationSolver::addOverlay(const Skeleton* sk,uint64_t time) {
   if(sk==nullptr)
     return;
@@ -63,7 +120,26 @@ void AnimationSolver::addOverlay(const Skeleton* sk,uint64_t time) {
   invalidateCache();
   }
 
+void AnimationSolver::addOverlay(std::string_view sk, uint64_t time) {
+  if(sk.empty())
+    return;
+  Pending p;
+  p.name     = std::string(sk);
+  p.skeleton = Resources::loadSkeletonAsync(sk);
+  p.time     = time;
+  if(isReady(p)) {
+    addOverlay(p.skeleton.get(),time);
+    return;
+    }
+  pending.emplace_back(std::move(p));
+  }
+
 void AnimationSolver::delOverlay(std::string_view sk) {
+  for(size_t i=0;i<pending.size();++i)
+    if(pending[i].name==sk) {
+      pending.erase(pending.begin()+int(i));
+      return;
+      }
   if(overlay.size()==0)
     return;
   auto skelet = Resources::loadSkeleton(sk);
@@ -71,6 +147,11 @@ void AnimationSolver::delOverlay(std::string_view sk) {
   }
 
 void AnimationSolver::delOverlay(const Skeleton *sk) {
+  for(size_t i=0;i<pending.size();++i)
+    if(isReady(pending[i]) && pending[i].skeleton.get()==sk) {
+      pending.erase(pending.begin()+int(i));
+      return;
+      }
   for(size_t i=0;i<overlay.size();++i)
     if(overlay[i].skeleton==sk){
       overlay.erase(overlay.begin()+int(i));
@@ -81,10 +162,13 @@ void AnimationSolver::delOverlay(const Skeleton *sk) {
 
 void AnimationSolver::clearOverlays() {
   overlay.clear();
+  pending.clear();
   invalidateCache();
   }
 
 void AnimationSolver::update(uint64_t tickCount) {
+  if(pending.size()>0)
+    updatePending(tickCount);
   for(size_t i=0;i<overlay.size();){
     auto& ov = overlay[i];
     if(ov.time!=0 && ov.time<tickCount) {
@@ -96,14 +180,27 @@ void AnimationSolver::update(uint64_t tickCount) {
     }
   }
 
-const Animation::Sequence* AnimationSolver::solveAnim(AnimationSolver::Anim a, WeaponState st, WalkBit wlkMode, const Pose& pose) const {
-  if(0<a && a<=AnimationSolver::CacheLast && int(st)<2 && int(wlkMode)<2) {
-    auto& ptr = cache[a-1][int(st)][int(wlkMode)];
-    if(ptr==nullptr)
-      ptr = implSolveAnim(a,st,wlkMode,pose);
-    return ptr;
+void AnimationSolver::updatePending(uint64_t tickCount) {
+  for(size_t i=0;i<pending.size();) {
+    auto& p = pending[i];
+    if(!isReady(p)) {
+      ++i;
+      continue;
+      }
+    if(p.time==0 || p.time>=tickCount)
+      addOverlay(p.skeleton.get(),p.time);
+    pending.erase(pending.begin()+int(i));
     }
-  return implSolveAnim(a,st,wlkMode,pose);
+  }
+
+bool AnimationSolver::isReady(const Pending& p) {
+  return p.skeleton.wait_for(std::chrono::seconds(0))==std::future_status::ready;
+  }
+
+const Animation::Sequence* AnimationSolver::solveAnim(AnimationSolver::Anim a, WeaponState st, WalkBit wlkMode, const Pose& pose) const {
+  if(a>AnimLast || int(st)>=WeaponCount || isPoseDependent(a,wlkMode))
+    return implSolveAnim(a,st,wlkMode,pose);
+  return table().anim[a][int(st)][walkClass(wlkMode)];
   }
 
 const Animation::Sequence* AnimationSolver::implSolveAnim(AnimationSolver::Anim a, WeaponState st, WalkBit wlkMode, const Pose& pose) const {
@@ -114,19 +211,11 @@ const Animation::Sequence* AnimationSolver::implSolveAnim(AnimationSolver::Anim
         return solveFrm("T_FISTATTACKMOVE");
       return solveFrm("S_FISTATTACK");
       }
-    if(a==Anim::AtackBlock)
-      return solveFrm("T_FISTPARADE_0");
     }
   else if(st==WeaponState::W1H || st==WeaponState::W2H) {
     if(a==Anim::Atack && (pose.isInAnim("S_1HWALKL") || pose.isInAnim("S_1HRUNL") ||
                           pose.isInAnim("S_2HWALKL") || pose.isInAnim("S_2HRUNL")))
       return solveFrm("T_%sATTACKMOVE",st);
-    if(a==Anim::AtackL)
-      return solveFrm("T_%sATTACKL",st);
-    if(a==Anim::AtackR)
-      return solveFrm("T_%sATTACKR",st);
-    if(a==Anim::Atack || a==Anim::AtackL || a==Anim::AtackR)
-      return solveFrm("S_%sATTACK",st); // TODO: proper atack  window
     if(a==Anim::AtackBlock) {
       const Animation::Sequence* s=nullptr;
       switch(std::rand()%3){
@@ -138,8 +227,6 @@ const Animation::Sequence* AnimationSolver::implSolveAnim(AnimationSolver::Anim
         s = solveFrm("T_%sPARADE_0",st);
       return s;
       }
-    if(a==Anim::AtackFinish)
-      return solveFrm("T_%sSFINISH",st);
     }
   else if(st==WeaponState::Bow || st==WeaponState::CBow) {
     // S_BOWAIM -> S_BOWSHOOT+T_BOWRELOAD -> S_BOWAIM
@@ -155,7 +242,63 @@ const Animation::Sequence* AnimationSolver::implSolveAnim(AnimationSolver::Anim
       auto bs = pose.bodyState();
       if(bs==BS_AIMNEAR || bs==BS_AIMFAR)
         return solveFrm("S_%sSHOOT",st);
+      return nullptr;
+      }
+    }
+  if(a==Move && bool(wlkMode & WalkBit::WM_Dive)) {
+    if(pose.bodyState()==BS_DIVE)
+      return solveFrm("S_DIVEF",st); else
+      return solveFrm("S_DIVE");
+    }
+
+  if(a==JumpHang) {
+    if(pose.bodyState()==BS_JUMP)  {
+      if(auto ret = solveFrm("T_JUMPUP_2_HANG"))
+        return ret;
       }
+    //return solveFrm("S_HANG");
+    return solveFrm("T_HANG_2_STAND");
+    }
+
+  if(a==Anim::DeadA) {
+    if(pose.isInAnim("S_WOUNDED")  || pose.isInAnim("T_STAND_2_WOUNDED") ||
+       pose.isInAnim("S_WOUNDEDB") || pose.isInAnim("T_STAND_2_WOUNDEDB"))
+      return solveDead("T_WOUNDED_2_DEAD","T_WOUNDEDB_2_DEADB");
+    if(pose.bodyState()==BS_FALL)
+      return solveDead("T_DEAD", "T_DEADB");
+    if(pose.hasAnim())
+      return solveDead("T_DEAD", "T_DEADB");
+    return solveDead("S_DEAD", "S_DEADB");
+    }
+  if(a==Anim::DeadB) {
+    if(pose.isInAnim("S_WOUNDED")  || pose.isInAnim("T_STAND_2_WOUNDED") ||
+       pose.isInAnim("S_WOUNDEDB") || pose.isInAnim("T_STAND_2_WOUNDEDB"))
+      return solveDead("T_WOUNDEDB_2_DEADB","T_WOUNDED_2_DEAD");
+    if(pose.hasAnim())
+      return solveDead("T_DEADB","T_DEAD"); else
+      return solveDead("S_DEADB","S_DEAD");
+    }
+
+  return implSolveAnim(a,st,wlkMode);
+  }
+
+const Animation::Sequence* AnimationSolver::implSolveAnim(AnimationSolver::Anim a, WeaponState st, WalkBit wlkMode) const {
+  // Atack
+  if(st==WeaponState::Fist) {
+    if(a==Anim::AtackBlock)
+      return solveFrm("T_FISTPARADE_0");
+    }
+  else if(st==WeaponState::W1H || st==WeaponState::W2H) {
+    if(a==Anim::AtackL)
+      return solveFrm("T_%sATTACKL",st);
+    if(a==Anim::AtackR)
+      return solveFrm("T_%sATTACKR",st);
+    if(a==Anim::Atack || a==Anim::AtackL || a==Anim::AtackR)
+      return solveFrm("S_%sATTACK",st); // TODO: proper atack  window
+    if(a==Anim::AtackFinish)
+      return solveFrm("T_%sSFINISH",st);
+    }
+  else if(st==WeaponState::Bow || st==WeaponState::CBow) {
     if(a==Anim::Idle)
       return solveFrm("S_%sRUN",st);
     }
@@ -174,11 +317,6 @@ const Animation::Sequence* AnimationSolver::implSolveAnim(AnimationSolver::Anim
     return solveFrm("S_%sRUN",st);
     }
   if(a==Move)  {
-    if(bool(wlkMode & WalkBit::WM_Dive)) {
-      if(pose.bodyState()==BS_DIVE)
-        return solveFrm("S_DIVEF",st); else
-        return solveFrm("S_DIVE");
-      }
     if(bool(wlkMode & WalkBit::WM_Swim))
       return solveFrm("S_SWIMF",st);
     if(bool(wlkMode & WalkBit::WM_Sneak))
@@ -263,15 +401,6 @@ const Animation::Sequence* AnimationSolver::implSolveAnim(AnimationSolver::Anim
   if(a==JumpUp)
     return solveFrm("S_JUMPUP");
 
-  if(a==JumpHang) {
-    if(pose.bodyState()==BS_JUMP)  {
-      if(auto ret = solveFrm("T_JUMPUP_2_HANG"))
-        return ret;
-      }
-    //return solveFrm("S_HANG");
-    return solveFrm("T_HANG_2_STAND");
-    }
-
   if(a==Anim::Fallen)
     return solveFrm("S_FALLEN"); //TODO: S_FALLENB
   if(a==Anim::Fall)
@@ -286,25 +415,6 @@ const Animation::Sequence* AnimationSolver::implSolveAnim(AnimationSolver::Anim
     return solveFrm("T_STUMBLE");
   if(a==Anim::StumbleB)
     return solveFrm("T_STUMBLEB");
-  if(a==Anim::DeadA) {
-    if(pose.isInAnim("S_WOUNDED")  || pose.isInAnim("T_STAND_2_WOUNDED") ||
-       pose.isInAnim("S_WOUNDEDB") || pose.isInAnim("T_STAND_2_WOUNDEDB"))
-      return solveDead("T_WOUNDED_2_DEAD","T_WOUNDEDB_2_DEADB");
-    if(pose.bodyState()==BS_FALL)
-      return solveDead("T_DEAD", "T_DEADB");
-    if(pose.hasAnim())
-      return solveDead("T_DEAD", "T_DEADB");
-    return solveDead("S_DEAD", "S_DEADB");
-    }
-  if(a==Anim::DeadB) {
-    if(pose.isInAnim("S_WOUNDED")  || pose.isInAnim("T_STAND_2_WOUNDED") ||
-       pose.isInAnim("S_WOUNDEDB") || pose.isInAnim("T_STAND_2_WOUNDEDB"))
-      return solveDead("T_WOUNDEDB_2_DEADB","T_WOUNDED_2_DEAD");
-    if(pose.hasAnim())
-      return solveDead("T_DEADB","T_DEAD"); else
-      return solveDead("S_DEADB","S_DEAD");
-    }
-
   if(a==Anim::UnconsciousA)
     return solveFrm("T_STAND_2_WOUNDED");
   if(a==Anim::UnconsciousB)
@@ -321,6 +431,12 @@ const Animation::Sequence* AnimationSolver::implSolveAnim(AnimationSolver::Anim
   }
 
 const Animation::Sequence *AnimationSolver::solveAnim(WeaponState st, WeaponState cur, bool run) const {
+  if(int(st)>=WeaponCount || int(cur)>=WeaponCount)
+    return implSolveAnim(st,cur,run);
+  return table().draw[int(st)][int(cur)][run ? 1 : 0];
+  }
+
+const Animation::Sequence *AnimationSolver::implSolveAnim(WeaponState st, WeaponState cur, bool run) const {
   // Weapon draw/undraw
   if(st==cur)
     return nullptr;
@@ -399,7 +515,57 @@ const Animation::Sequence *AnimationSolver::solveDead(std::string_view format1,
   }
 
 void AnimationSolver::invalidateCache() {
-  std::memset(cache,0,sizeof(cache));
+  cache = nullptr;
+  }
+
+struct AnimationSolver::Registry final {
+  std::mutex                                                sync;
+  std::map<std::vector<const Skeleton*>,std::unique_ptr<Table>> tables;
+  };
+
+AnimationSolver::Registry& AnimationSolver::registry() {
+  static Registry r;
+  return r;
+  }
+
+void AnimationSolver::dropTables(const std::vector<const Skeleton*>& evicted) {
+  auto& r = registry();
+  std::lock_guard<std::mutex> guard(r.sync);
+  for(auto it=r.tables.begin(); it!=r.tables.end();) {
+    bool drop = false;
+    for(auto sk:it->first)
+      drop |= std::find(evicted.begin(),evicted.end(),sk)!=evicted.end();
+    if(drop)
+      it = r.tables.erase(it); else
+      ++it;
+    }
+  }
+
+const AnimationSolver::Table& AnimationSolver::table() const {
+  if(cache!=nullptr)
+    return *cache;
+
+  std::vector<const Skeleton*> key(overlay.size()+1);
+  key[0] = baseSk;
+  for(size_t i=0; i<overlay.size(); ++i)
+    key[i+1] = overlay[i].skeleton;
+
+  auto& r = registry();
+  std::lock_guard<std::mutex> guard(r.sync);
+  auto& t = r.tables[std::move(key)];
+  if(t==nullptr) {
+    t.reset(new Table());
+    for(int a=0; a<=AnimLast; ++a)
+      for(int st=0; st<WeaponCount; ++st)
+        for(int w=0; w<WalkCount; ++w)
+          t->anim[a][st][w] = implSolveAnim(Anim(a),WeaponState(st),walkClassBits[w]);
+    for(int st=0; st<WeaponCount; ++st)
+      for(int cur=0; cur<WeaponCount; ++cur)
+        for(int run=0; run<2; ++run)
+          t->draw[st][cur][run] = implSolveAnim(WeaponState(st),WeaponState(cur),run!=0);
+    }
+  cache = t.get();
+  return *cache;
   }
 
 const Animation::Sequence* AnimationSolver::solveNext(const Animation::Sequence& sq) const {
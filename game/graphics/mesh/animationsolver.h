@@ -2,6 +2,7 @@
 
 #include <Tempest/Matrix4x4>
 #include <vector>
+#include <future>
 
 #include "game/constants.h"
 #include "animation.h"
@@ -21,8 +22,6 @@ class AnimationSolver final {
       NoAnim,
       Idle,
       Move,
-      CacheLast = Move,
-
       MoveBack,
       MoveL,
       MoveR,
@@ -63,7 +62,8 @@ class AnimationSolver final {
       ItmGet,
       ItmDrop,
 
-      MagNoMana
+      MagNoMana,
+      AnimLast = MagNoMana
       };
 
     struct Overlay final {
@@ -75,10 +75,13 @@ class AnimationSolver final {
     void                           load(Serialize& fin);
 
     void                           setSkeleton(const Skeleton* sk);
+    static void                    dropTables(const std::vector<const Skeleton*>& evicted);
     void                           update(uint64_t tickCount);
 
     bool                           hasOverlay(const Skeleton*  sk) const;
+    bool                           hasOverlay(std::string_view sk) const;
     void                           addOverlay(const Skeleton*  sk, uint64_t time);
+    void                           addOverlay(std::string_view sk, uint64_t time);
     void                           delOverlay(std::string_view sk);
     void                           delOverlay(const Skeleton*  sk);
     void                           clearOverlays();
@@ -90,16 +93,35 @@ class AnimationSolver final {
     const Animation::Sequence*     solveAnim(Interactive *inter, Anim a, const Pose &pose) const;
 
   private:
+    // resolved animations for one base skeleton + overlay stack; shared between all solvers with same stack
+    struct Table;
+
     const Animation::Sequence*     solveFrm    (std::string_view format, WeaponState st) const;
 
     const Animation::Sequence*     solveMag    (std::string_view format, const std::string& spell) const;
     const Animation::Sequence*     solveDead   (std::string_view format1, std::string_view format2) const;
 
     const Animation::Sequence*     implSolveAnim(Anim a, WeaponState st, WalkBit wlk, const Pose &pose) const;
+    const Animation::Sequence*     implSolveAnim(Anim a, WeaponState st, WalkBit wlk) const;
+    const Animation::Sequence*     implSolveAnim(WeaponState st, WeaponState cur, bool run) const;
+    const Table&                   table() const;
+    struct Registry;
+    static Registry&               registry();
     void                           invalidateCache();
 
+    // overlay, that is still loading in background; until then animations resolve without it
+    struct Pending final {
+      std::string                         name;
+      std::shared_future<const Skeleton*> skeleton;
+      uint64_t                            time = 0;
+      };
+
+    void                           updatePending(uint64_t tickCount);
+    static bool                    isReady(const Pending& p);
+
     const Skeleton*                baseSk=nullptr;
     std::vector<Overlay>           overlay;
+    std::vector<Pending>           pending;
 
-    mutable const Animation::Sequence* cache [CacheLast][2][2] = {};
+    mutable const Table*           cache = nullptr;
   };
@@ -1,6 +1,7 @@
 #include "animmath.h"
 
 #include <cmath>
+#include <algorithm>
 
 static float mix(float x,float y,float a){
   return x+(y-x)*a;
@@ -95,3 +96,161 @@ Tempest::Matrix4x4 mkMatrix(const ZenLoad::zCModelAniSample& s) {
   return mkMatrix(s.rotation.x,s.rotation.y,s.rotation.z,s.rotation.w,
                   s.position.x,s.position.y,s.position.z);
   }
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#include <emmintrin.h>
+#define ANIMMATH_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define ANIMMATH_NEON
+#endif
+
+namespace {
+
+#if defined(ANIMMATH_SSE)
+using f4 = __m128;
+inline f4   load (const float* p)  { return _mm_loadu_ps(p);     }
+inline void store(float* p, f4 v)  { _mm_storeu_ps(p,v);         }
+inline f4   set1 (float v)         { return _mm_set1_ps(v);      }
+inline f4   add  (f4 a, f4 b)      { return _mm_add_ps(a,b);     }
+inline f4   sub  (f4 a, f4 b)      { return _mm_sub_ps(a,b);     }
+inline f4   mul  (f4 a, f4 b)      { return _mm_mul_ps(a,b);     }
+inline f4   div  (f4 a, f4 b)      { return _mm_div_ps(a,b);     }
+inline f4   sqrt (f4 a)            { return _mm_sqrt_ps(a);      }
+// 1 or -1, with sign of 'a'
+inline f4   sign1(f4 a)            { return _mm_or_ps(_mm_and_ps(a,_mm_set1_ps(-0.f)),_mm_set1_ps(1.f)); }
+#elif defined(ANIMMATH_NEON)
+using f4 = float32x4_t;
+inline f4   load (const float* p)  { return vld1q_f32(p);        }
+inline void store(float* p, f4 v)  { vst1q_f32(p,v);             }
+inline f4   set1 (float v)         { return vdupq_n_f32(v);      }
+inline f4   add  (f4 a, f4 b)      { return vaddq_f32(a,b);      }
+inline f4   sub  (f4 a, f4 b)      { return vsubq_f32(a,b);      }
+inline f4   mul  (f4 a, f4 b)      { return vmulq_f32(a,b);      }
+inline f4   div  (f4 a, f4 b)      {
+  // two Newton-Raphson steps: close to IEEE division for normalization purposes
+  f4 r = vrecpeq_f32(b);
+  r = vmulq_f32(vrecpsq_f32(b,r),r);
+  r = vmulq_f32(vrecpsq_f32(b,r),r);
+  return vmulq_f32(a,r);
+  }
+inline f4   sqrt (f4 a)            {
+  f4 r = vrsqrteq_f32(vmaxq_f32(a,vdupq_n_f32(1e-30f)));
+  r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a,r),r),r);
+  r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a,r),r),r);
+  return vmulq_f32(a,r);
+  }
+inline f4   sign1(f4 a)            { return vbslq_f32(vcltq_f32(a,vdupq_n_f32(0)),vdupq_n_f32(-1.f),vdupq_n_f32(1.f)); }
+#else
+struct f4 { float v[4]; };
+inline f4   load (const float* p)  { return f4{{p[0],p[1],p[2],p[3]}}; }
+inline void store(float* p, f4 a)  { for(int i=0;i<4;++i) p[i]=a.v[i]; }
+inline f4   set1 (float v)         { return f4{{v,v,v,v}}; }
+inline f4   add  (f4 a, f4 b)      { for(int i=0;i<4;++i) a.v[i]+=b.v[i]; return a; }
+inline f4   sub  (f4 a, f4 b)      { for(int i=0;i<4;++i) a.v[i]-=b.v[i]; return a; }
+inline f4   mul  (f4 a, f4 b)      { for(int i=0;i<4;++i) a.v[i]*=b.v[i]; return a; }
+inline f4   div  (f4 a, f4 b)      { for(int i=0;i<4;++i) a.v[i]/=b.v[i]; return a; }
+inline f4   sqrt (f4 a)            { for(int i=0;i<4;++i) a.v[i]=std::sqrt(a.v[i]); return a; }
+inline f4   sign1(f4 a)            { for(int i=0;i<4;++i) a.v[i]=(a.v[i]<0 ? -1.f : 1.f); return a; }
+#endif
+
+inline f4 mix(f4 x, f4 y, f4 a) {
+  return add(x,mul(sub(y,x),a));
+  }
+
+}
+
+size_t soaStride(size_t count) {
+  return (count+3)&~size_t(3);
+  }
+
+void toSoA(float* dst, size_t stride, const ZenLoad::zCModelAniSample* src, size_t count) {
+  for(size_t i=0; i<stride; ++i) {
+    // padding: identity rotation, to keep normalization well-defined
+    const bool pad = (i>=count);
+    dst[SmpQx*stride+i] = pad ? 0.f : src[i].rotation.x;
+    dst[SmpQy*stride+i] = pad ? 0.f : src[i].rotation.y;
+    dst[SmpQz*stride+i] = pad ? 0.f : src[i].rotation.z;
+    dst[SmpQw*stride+i] = pad ? 1.f : src[i].rotation.w;
+    dst[SmpPx*stride+i] = pad ? 0.f : src[i].position.x;
+    dst[SmpPy*stride+i] = pad ? 0.f : src[i].position.y;
+    dst[SmpPz*stride+i] = pad ? 0.f : src[i].position.z;
+    }
+  }
+
+ZenLoad::zCModelAniSample fromSoA(const float* src, size_t stride, size_t id) {
+  ZenLoad::zCModelAniSample r;
+  r.rotation.x = src[SmpQx*stride+id];
+  r.rotation.y = src[SmpQy*stride+id];
+  r.rotation.z = src[SmpQz*stride+id];
+  r.rotation.w = src[SmpQw*stride+id];
+  r.position.x = src[SmpPx*stride+id];
+  r.position.y = src[SmpPy*stride+id];
+  r.position.z = src[SmpPz*stride+id];
+  return r;
+  }
+
+void mixSoA(float* dst, const float* x, const float* y, float a, size_t stride) {
+  const f4 t = set1(a);
+  for(size_t i=0; i<stride; i+=4) {
+    f4 qx0 = load(x+SmpQx*stride+i), qy0 = load(x+SmpQy*stride+i), qz0 = load(x+SmpQz*stride+i), qw0 = load(x+SmpQw*stride+i);
+    f4 qx1 = load(y+SmpQx*stride+i), qy1 = load(y+SmpQy*stride+i), qz1 = load(y+SmpQz*stride+i), qw1 = load(y+SmpQw*stride+i);
+
+    // take shortest path
+    f4 dot = add(add(mul(qx0,qx1),mul(qy0,qy1)),add(mul(qz0,qz1),mul(qw0,qw1)));
+    f4 sgn = sign1(dot);
+    qx1 = mul(qx1,sgn);
+    qy1 = mul(qy1,sgn);
+    qz1 = mul(qz1,sgn);
+    qw1 = mul(qw1,sgn);
+
+    f4 qx = mix(qx0,qx1,t), qy = mix(qy0,qy1,t), qz = mix(qz0,qz1,t), qw = mix(qw0,qw1,t);
+    f4 len = sqrt(add(add(mul(qx,qx),mul(qy,qy)),add(mul(qz,qz),mul(qw,qw))));
+    store(dst+SmpQx*stride+i, div(qx,len));
+    store(dst+SmpQy*stride+i, div(qy,len));
+    store(dst+SmpQz*stride+i, div(qz,len));
+    store(dst+SmpQw*stride+i, div(qw,len));
+
+    store(dst+SmpPx*stride+i, mix(load(x+SmpPx*stride+i),load(y+SmpPx*stride+i),t));
+    store(dst+SmpPy*stride+i, mix(load(x+SmpPy*stride+i),load(y+SmpPy*stride+i),t));
+    store(dst+SmpPz*stride+i, mix(load(x+SmpPz*stride+i),load(y+SmpPz*stride+i),t));
+    }
+  }
+
+void mkMatrixSoA(Tempest::Matrix4x4* dst, const float* src, size_t stride, size_t count) {
+  const f4 two = set1(2.f);
+  for(size_t i=0; i<count; i+=4) {
+    f4 x = load(src+SmpQx*stride+i), y = load(src+SmpQy*stride+i);
+    f4 z = load(src+SmpQz*stride+i), w = load(src+SmpQw*stride+i);
+
+    f4 xx = mul(x,x), yy = mul(y,y), zz = mul(z,z), ww = mul(w,w);
+    f4 xy = mul(x,y), xz = mul(x,z), yz = mul(y,z);
+    f4 wx = mul(w,x), wy = mul(w,y), wz = mul(w,z);
+
+    // same layout as scalar mkMatrix
+    alignas(16) float m[12][4];
+    store(m[0],  sub(sub(add(ww,xx),yy),zz));
+    store(m[1],  mul(two,sub(xy,wz)));
+    store(m[2],  mul(two,add(xz,wy)));
+    store(m[3],  mul(two,add(xy,wz)));
+    store(m[4],  sub(add(sub(ww,xx),yy),zz));
+    store(m[5],  mul(two,sub(yz,wx)));
+    store(m[6],  mul(two,sub(xz,wy)));
+    store(m[7],  mul(two,add(yz,wx)));
+    store(m[8],  add(sub(sub(ww,xx),yy),zz));
+    store(m[9],  load(src+SmpPx*stride+i));
+    store(m[10], load(src+SmpPy*stride+i));
+    store(m[11], load(src+SmpPz*stride+i));
+
+    const size_t cnt = std::min<size_t>(4,count-i);
+    for(size_t r=0; r<cnt; ++r) {
+      float mt[4][4] = {
+        {m[0][r], m[1][r],  m[2][r],  0},
+        {m[3][r], m[4][r],  m[5][r],  0},
+        {m[6][r], m[7][r],  m[8][r],  0},
+        {m[9][r], m[10][r], m[11][r], 1},
+        };
+      dst[i+r] = Tempest::Matrix4x4(reinterpret_cast<float*>(mt));
+      }
+    }
+  }
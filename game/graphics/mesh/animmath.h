@@ -6,3 +6,17 @@
 
 ZenLoad::zCModelAniSample mix(const ZenLoad::zCModelAniSample& x,const ZenLoad::zCModelAniSample& y,float a);
 Tempest::Matrix4x4        mkMatrix(const ZenLoad::zCModelAniSample& s);
+
+// Structure-of-arrays samples: SmpRows rows of 'stride' floats; stride is a multiple of 4
+enum SampleRow : uint8_t {
+  SmpQx, SmpQy, SmpQz, SmpQw,
+  SmpPx, SmpPy, SmpPz,
+  SmpRows
+  };
+
+size_t                    soaStride(size_t count);
+void                      toSoA (float* dst, size_t stride, const ZenLoad::zCModelAniSample* src, size_t count);
+ZenLoad::zCModelAniSample fromSoA(const float* src, size_t stride, size_t id);
+// nlerp for rotation, lerp for position; dst may alias x
+void                      mixSoA(float* dst, const float* x, const float* y, float a, size_t stride);
+void                      mkMatrixSoA(Tempest::Matrix4x4* dst, const float* src, size_t stride, size_t count);
@@ -9,10 +9,84 @@
 #include "skeleton.h"
 #include "animmath.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <unordered_map>
 
 using namespace Tempest;
 
+namespace {
+// state of a pose, that has no per-instance layers; crowds in idle share same palette
+struct SharedPose final {
+  enum : uint32_t {
+    AlphaSteps = 8,
+    MaxCount   = 512,
+    };
+  const Skeleton*            skeleton = nullptr;
+  const Animation::Sequence* seq      = nullptr;
+  uint32_t                   frameA   = 0;
+  uint32_t                   frameB   = 0;
+  uint32_t                   alpha    = 0;
+  uint32_t                   bs       = 0;
+  uint32_t                   flag     = 0;
+  uint32_t                   trY      = 0; // root height, used by BS_CLIMB translation
+
+  bool operator == (const SharedPose& o) const {
+    return skeleton==o.skeleton && seq==o.seq && frameA==o.frameA && frameB==o.frameB &&
+           alpha==o.alpha && bs==o.bs && flag==o.flag && trY==o.trY;
+    }
+  };
+
+struct SharedPoseHash final {
+  size_t operator()(const SharedPose& k) const {
+    size_t h = std::hash<const void*>()(k.skeleton);
+    h = h*31 + std::hash<const void*>()(k.seq);
+    h = h*31 + k.frameA;
+    h = h*31 + k.frameB;
+    h = h*31 + k.alpha;
+    h = h*31 + k.bs;
+    h = h*31 + k.flag;
+    h = h*31 + k.trY;
+    return h;
+    }
+  };
+
+struct SharedPalette final {
+  alignas(16) float  base[SmpRows*Resources::MAX_NUM_SKELETAL_NODES] = {};
+  Tempest::Matrix4x4 tr  [Resources::MAX_NUM_SKELETAL_NODES];
+  };
+
+struct SharedEntry final {
+  std::shared_ptr<const SharedPalette> palette;
+  uint64_t                             lastUse = 0;
+  };
+}
+
+static std::mutex sharedSync;
+static std::unordered_map<SharedPose,SharedEntry,SharedPoseHash> sharedPoses;
+
+// drop least recently used quarter of palettes
+static void evictSharedPoses() {
+  std::vector<uint64_t> use;
+  use.reserve(sharedPoses.size());
+  for(auto& i:sharedPoses)
+    use.push_back(i.second.lastUse);
+  auto nth = use.begin()+int(use.size()/4);
+  std::nth_element(use.begin(),nth,use.end());
+  const uint64_t barrier = *nth;
+  for(auto it=sharedPoses.begin(); it!=sharedPoses.end();) {
+    if(it->second.lastUse<=barrier)
+      it = sharedPoses.erase(it); else
+      ++it;
+    }
+  }
+
+void Pose::dropSharedPoses() {
+  std::lock_guard<std::mutex> guard(sharedSync);
+  sharedPoses.clear();
+  }
+
 uint8_t Pose::calcAniComb(const Vec3& dpos, float rotation) {
   float   l   = std::sqrt(dpos.x*dpos.x+dpos.z*dpos.z);
 
@@ -53,8 +127,8 @@ void Pose::save(Serialize &fout) {
   fout.write(itemUseSt,itemUseDestSt);
   fout.write(headRotX,headRotY);
 
-  for(auto& i:base)
-    fout.write(i);
+  for(size_t i=0; i<Resources::MAX_NUM_SKELETAL_NODES; ++i)
+    fout.write(sample(i));
   for(auto& i:tr)
     fout.write(i);
   }
@@ -86,8 +160,11 @@ void Pose::load(Serialize &fin, const AnimationSolver& solver) {
   needToUpdate = true;
 
   numBones = skeleton==nullptr ? 0 : skeleton->nodes.size();
-  for(auto& i:base)
-    fin.read(i);
+  for(size_t i=0; i<Resources::MAX_NUM_SKELETAL_NODES; ++i) {
+    ZenLoad::zCModelAniSample s;
+    fin.read(s);
+    setSample(i,s);
+    }
   for(auto& i:tr)
     fin.read(i);
   }
@@ -110,8 +187,8 @@ void Pose::setSkeleton(const Skeleton* sk) {
   if(skeleton!=nullptr) {
     numBones = skeleton->tr.size();
     for(size_t i=0; i<numBones; ++i) {
-      tr[i]   = skeleton->tr[i];
-      base[i] = ZenLoad::zCModelAniSample{}; //mkSample(skeleton->nodes[i].tr);
+      tr[i] = skeleton->tr[i];
+      setSample(i,ZenLoad::zCModelAniSample{});
       }
     } else {
     numBones = 0;
@@ -280,7 +357,15 @@ bool Pose::update(uint64_t tickCount) {
     return ret;
     }
 
+  if(lastUpdate!=tickCount && isShareable()) {
+    const bool ret = updateShared(tickCount);
+    needToUpdate = false;
+    lastUpdate   = tickCount;
+    return ret;
+    }
+
   if(lastUpdate!=tickCount) {
+    sharedKey = 0;
     for(auto& i:lay) {
       const Animation::Sequence* seq = i.seq;
       if(0<i.comb && i.comb<=i.seq->comb.size()) {
@@ -305,20 +390,27 @@ bool Pose::updateFrame(const Animation::Sequence &s,
   auto&        d         = *s.data;
   const size_t numFrames = d.numFrames;
   const size_t idSize    = d.nodeIndex.size();
-  if(numFrames==0 || idSize==0 || d.samples.size()%idSize!=0)
+  if(numFrames==0 || idSize==0 || d.stride>Resources::MAX_NUM_SKELETAL_NODES || d.sampleFrames<numFrames)
     return false;
   if(numFrames==1 && !needToUpdate)
     return false;
 
   (void)barrier;
-  now = now-sTime;
+  uint64_t frameA = 0, frameB = 0;
+  float    a      = 0;
+  frameAt(s,sTime,now,frameA,frameB,a);
+  sampleFrame(s,frameA,frameB,a);
+  return true;
+  }
 
+void Pose::frameAt(const Animation::Sequence& s, uint64_t sTime, uint64_t now,
+                   uint64_t& frameA, uint64_t& frameB, float& a) {
+  auto&    d       = *s.data;
   float    fpsRate = d.fpsRate;
-  uint64_t frame   = uint64_t(float(now)*fpsRate);
-  uint64_t frameA  = frame/1000;
-  uint64_t frameB  = frame/1000+1; //next
-
-  float    a       = float(frame%1000)/1000.f;
+  uint64_t frame   = uint64_t(float(now-sTime)*fpsRate);
+  frameA = frame/1000;
+  frameB = frame/1000+1; //next
+  a      = float(frame%1000)/1000.f;
 
   if(s.animCls==Animation::Loop){
     frameA%=d.numFrames;
@@ -332,16 +424,92 @@ bool Pose::updateFrame(const Animation::Sequence &s,
     frameA = d.numFrames-1-frameA;
     frameB = d.numFrames-1-frameB;
     }
+  }
+
+void Pose::sampleFrame(const Animation::Sequence& s, uint64_t frameA, uint64_t frameB, float a) {
+  auto&        d      = *s.data;
+  const size_t idSize = d.nodeIndex.size();
 
-  auto* sampleA = &d.samples[size_t(frameA*idSize)];
-  auto* sampleB = &d.samples[size_t(frameB*idSize)];
+  alignas(16) float frame [SmpRows*Resources::MAX_NUM_SKELETAL_NODES];
+  alignas(16) float sampleB[SmpRows*Resources::MAX_NUM_SKELETAL_NODES];
+  d.decodeFrame(size_t(frameA),frame);
+  if(frameA!=frameB) {
+    d.decodeFrame(size_t(frameB),sampleB);
+    mixSoA(frame,frame,sampleB,a,d.stride);
+    }
 
   for(size_t i=0; i<idSize; ++i) {
     size_t idx = d.nodeIndex[i];
     if(idx>=numBones)
       continue;
-    base[idx] = mix(sampleA[i],sampleB[i],a);
+    for(size_t r=0; r<SmpRows; ++r)
+      base[r*Resources::MAX_NUM_SKELETAL_NODES+idx] = frame[r*d.stride+i];
+    }
+  }
+
+bool Pose::isShareable() const {
+  // single full-body layer, no procedural bones: palette is a function of (skeleton, sequence, frame) only
+  if(skeleton==nullptr || lay.size()!=1 || headRotX!=0 || headRotY!=0)
+    return false;
+  auto& l = lay[0];
+  if(l.comb!=0 || l.seq==nullptr || l.seq->data==nullptr)
+    return false;
+  auto& d = *l.seq->data;
+  return d.numFrames>0 && d.nodeIndex.size()>=numBones &&
+         d.stride<=Resources::MAX_NUM_SKELETAL_NODES && d.sampleFrames>=d.numFrames;
+  }
+
+bool Pose::updateShared(uint64_t tickCount) {
+  auto&    l      = lay[0];
+  auto&    s      = *l.seq;
+  uint64_t frameA = 0, frameB = 0;
+  float    a      = 0;
+  frameAt(s,l.sAnim,tickCount,frameA,frameB,a);
+
+  SharedPose key;
+  key.skeleton = skeleton;
+  key.seq      = &s;
+  key.frameA   = uint32_t(frameA);
+  key.frameB   = uint32_t(frameB);
+  key.alpha    = frameA==frameB ? 0 : uint32_t(std::lround(a*float(SharedPose::AlphaSteps)));
+  key.bs       = uint32_t(l.bs);
+  key.flag     = uint32_t(flag);
+  std::memcpy(&key.trY,&trY,sizeof(key.trY));
+
+  const uint64_t hash = uint64_t(SharedPoseHash()(key)) | 1;
+  if(hash==sharedKey && !needToUpdate)
+    return false;
+  sharedKey = hash;
+
+  std::shared_ptr<const SharedPalette> p;
+  {
+  std::lock_guard<std::mutex> guard(sharedSync);
+  auto it = sharedPoses.find(key);
+  if(it!=sharedPoses.end()) {
+    it->second.lastUse = tickCount;
+    p = it->second.palette;
+    }
+  }
+
+  if(p!=nullptr) {
+    std::memcpy(base,p->base,sizeof(base));
+    std::copy(p->tr,p->tr+numBones,tr);
+    return true;
     }
+
+  sampleFrame(s,frameA,frameB,float(key.alpha)/float(SharedPose::AlphaSteps));
+  mkSkeleton(s,l.bs);
+
+  auto px = std::make_shared<SharedPalette>();
+  std::memcpy(px->base,base,sizeof(base));
+  std::copy(tr,tr+numBones,px->tr);
+
+  std::lock_guard<std::mutex> guard(sharedSync);
+  if(sharedPoses.size()>=SharedPose::MaxCount)
+    evictSharedPoses();
+  auto& e = sharedPoses[key];
+  e.palette = std::move(px);
+  e.lastUse = tickCount;
   return true;
   }
 
@@ -349,9 +517,7 @@ void Pose::mkSkeleton(const Animation::Sequence &s, BodyState bs) {
   if(skeleton==nullptr)
     return;
   Matrix4x4 m = mkBaseTranslation(&s,bs);
-  if(skeleton->ordered)
-    mkSkeleton(m); else
-    mkSkeleton(m,size_t(-1));
+  mkSkeleton(m);
   }
 
 void Pose::mkSkeleton(const Matrix4x4 &mt) {
@@ -359,9 +525,13 @@ void Pose::mkSkeleton(const Matrix4x4 &mt) {
     return;
   auto& nodes      = skeleton->nodes;
   auto  BIP01_HEAD = skeleton->BIP01_HEAD;
-  for(size_t i=0; i<nodes.size(); ++i) {
+
+  Matrix4x4 local[Resources::MAX_NUM_SKELETAL_NODES];
+  mkMatrixSoA(local,base,Resources::MAX_NUM_SKELETAL_NODES,nodes.size());
+
+  for(auto i:skeleton->order) {
     size_t parent = nodes[i].parent;
-    auto   mat    = base[i].rotation.w==0 ? nodes[i].tr : mkMatrix(base[i]);
+    auto&  mat    = hasSample(i) ? local[i] : nodes[i].tr;
 
     if(parent<Resources::MAX_NUM_SKELETAL_NODES)
       tr[i] = tr[parent]*mat; else
@@ -375,17 +545,19 @@ void Pose::mkSkeleton(const Matrix4x4 &mt) {
     }
   }
 
-void Pose::mkSkeleton(const Tempest::Matrix4x4 &mt, size_t parent) {
-  if(skeleton==nullptr)
-    return;
-  auto& nodes = skeleton->nodes;
-  for(size_t i=0;i<nodes.size();++i){
-    if(nodes[i].parent!=parent)
-      continue;
-    auto mat = base[i].rotation.w==0 ? nodes[i].tr : mkMatrix(base[i]);
-    tr[i] = mt*mat;
-    mkSkeleton(tr[i],i);
-    }
+ZenLoad::zCModelAniSample Pose::sample(size_t id) const {
+  return fromSoA(base,Resources::MAX_NUM_SKELETAL_NODES,id);
+  }
+
+void Pose::setSample(size_t id, const ZenLoad::zCModelAniSample& s) {
+  const size_t stride = Resources::MAX_NUM_SKELETAL_NODES;
+  base[SmpQx*stride+id] = s.rotation.x;
+  base[SmpQy*stride+id] = s.rotation.y;
+  base[SmpQz*stride+id] = s.rotation.z;
+  base[SmpQw*stride+id] = s.rotation.w;
+  base[SmpPx*stride+id] = s.position.x;
+  base[SmpPy*stride+id] = s.position.y;
+  base[SmpPz*stride+id] = s.position.z;
   }
 
 const Animation::Sequence* Pose::solveNext(const AnimationSolver &solver, const Layer& lay) {
@@ -779,7 +951,7 @@ Matrix4x4 Pose::mkBaseTranslation(const Animation::Sequence *s, BodyState bs) {
   if(skeleton->rootNodes.size())
     id = skeleton->rootNodes[0];
   auto& nodes = skeleton->nodes;
-  auto  b0 = base[id].rotation.w==0 ? nodes[id].tr : mkMatrix(base[id]);
+  auto  b0 = hasSample(id) ? mkMatrix(sample(id)) : nodes[id].tr;
   float dx = b0.at(3,0);
   float dy = 0;
   float dz = b0.at(3,2);
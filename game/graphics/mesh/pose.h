@@ -7,6 +7,7 @@
 
 #include "game/constants.h"
 #include "animation.h"
+#include "animmath.h"
 #include "resources.h"
 
 class Skeleton;
@@ -30,6 +31,7 @@ class Pose final {
 
     static uint8_t     calcAniComb(const Tempest::Vec3& dpos, float rotation);
     static uint8_t     calcAniCombVert(const Tempest::Vec3& dpos);
+    static void        dropSharedPoses();
 
     void               save(Serialize& fout);
     void               load(Serialize& fin, const AnimationSolver &solver);
@@ -94,10 +96,19 @@ class Pose final {
     auto mkBaseTranslation(const Animation::Sequence *s, BodyState bs) -> Tempest::Matrix4x4;
     void mkSkeleton(const Animation::Sequence &s, BodyState bs);
     void mkSkeleton(const Tempest::Matrix4x4 &mt);
-    void mkSkeleton(const Tempest::Matrix4x4 &mt, size_t parent);
     void zeroSkeleton();
 
+    auto sample(size_t id) const -> ZenLoad::zCModelAniSample;
+    void setSample(size_t id, const ZenLoad::zCModelAniSample& s);
+    bool hasSample(size_t id) const { return base[SmpQw*Resources::MAX_NUM_SKELETAL_NODES+id]!=0; }
+
     bool updateFrame(const Animation::Sequence &s, uint64_t barrier, uint64_t sTime, uint64_t now);
+    void sampleFrame(const Animation::Sequence &s, uint64_t frameA, uint64_t frameB, float a);
+    static void frameAt(const Animation::Sequence &s, uint64_t sTime, uint64_t now,
+                        uint64_t& frameA, uint64_t& frameB, float& a);
+
+    bool isShareable() const;
+    bool updateShared(uint64_t tickCount);
 
     const Animation::Sequence* solveNext(const AnimationSolver& solver, const Layer& lay);
 
@@ -126,6 +137,7 @@ class Pose final {
     float                           trY=0;
     Flags                           flag=NoFlags;
     uint64_t                        lastUpdate=0;
+    uint64_t                        sharedKey =0; // last state taken from shared palettes, zero if none
     ComboState                      combo;
     bool                            needToUpdate = true;
     uint8_t                         hasEvents = 0;
@@ -134,6 +146,6 @@ class Pose final {
     float                           headRotX = 0, headRotY = 0;
 
     size_t                          numBones = 0;
-    ZenLoad::zCModelAniSample       base[Resources::MAX_NUM_SKELETAL_NODES] = {};
+    alignas(16) float               base[SmpRows*Resources::MAX_NUM_SKELETAL_NODES] = {}; // SoA, zero rotation - no sample
     Tempest::Matrix4x4              tr  [Resources::MAX_NUM_SKELETAL_NODES] = {};
   };
@@ -37,6 +37,18 @@ Skeleton::Skeleton(const ZenLoad::zCModelMeshLib& src, const Animation* anim, st
     if(nodes[i].parent==size_t(-1))
       rootNodes.push_back(i);
 
+  order.reserve(nodes.size());
+  if(ordered) {
+    for(size_t i=0;i<nodes.size();++i)
+      order.push_back(i);
+    } else {
+    order = rootNodes;
+    for(size_t r=0;r<order.size();++r)
+      for(size_t i=0;i<nodes.size();++i)
+        if(nodes[i].parent==order[r])
+          order.push_back(i);
+    }
+
   auto tr = src.getRootNodeTranslation();
   rootTr = Vec3{tr.x,tr.y,tr.z};
 
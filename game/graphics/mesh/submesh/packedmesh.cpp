@@ -3,11 +3,211 @@
 #include <Tempest/Log>
 #include <fstream>
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
 
 #include "graphics/bounds.h"
+#include "resources.h"
 
 using namespace Tempest;
 
+namespace {
+
+// bump, if layout of baked mesh is changed
+const uint32_t BakeVersion = 3;
+
+struct BakeWriter final {
+  std::vector<uint8_t>& out;
+
+  void write(const void* data, size_t size) {
+    auto p = reinterpret_cast<const uint8_t*>(data);
+    out.insert(out.end(),p,p+size);
+    }
+
+  template<class T>
+  void write(const T& v) {
+    static_assert(std::is_trivially_copyable<T>::value,"unsupported type");
+    write(&v,sizeof(v));
+    }
+
+  void write(const std::string& v) {
+    write(uint32_t(v.size()));
+    write(v.data(),v.size());
+    }
+
+  template<class T>
+  void write(const std::vector<T>& v) {
+    static_assert(std::is_trivially_copyable<T>::value,"unsupported type");
+    write(uint32_t(v.size()));
+    write(v.data(),v.size()*sizeof(T));
+    }
+  };
+
+struct BakeReader final {
+  const std::vector<uint8_t>& in;
+  size_t                      at = 0;
+
+  bool read(void* data, size_t size) {
+    if(in.size()-at<size)
+      return false;
+    std::memcpy(data,in.data()+at,size);
+    at += size;
+    return true;
+    }
+
+  template<class T>
+  bool read(T& v) {
+    static_assert(std::is_trivially_copyable<T>::value,"unsupported type");
+    return read(&v,sizeof(v));
+    }
+
+  bool read(std::string& v) {
+    uint32_t sz = 0;
+    if(!read(sz) || in.size()-at<sz)
+      return false;
+    v.assign(reinterpret_cast<const char*>(in.data()+at),sz);
+    at += sz;
+    return true;
+    }
+
+  template<class T>
+  bool read(std::vector<T>& v) {
+    static_assert(std::is_trivially_copyable<T>::value,"unsupported type");
+    uint32_t sz = 0;
+    if(!read(sz) || (in.size()-at)/sizeof(T)<sz)
+      return false;
+    v.resize(sz);
+    return read(v.data(),sz*sizeof(T));
+    }
+  };
+
+// vertex welding: open addressing over (vertex,feature) pairs, linear probing
+class WeldTable final {
+  public:
+    explicit WeldTable(size_t expected) {
+      size_t cap = 64;
+      while(cap<expected*2)
+        cap *= 2;
+      slot.resize(cap);
+      }
+
+    // returns value of existing key, or inserts new one
+    uint32_t insert(uint64_t key, uint32_t val) {
+      if((count+1)*2>slot.size())
+        grow();
+      const size_t mask = slot.size()-1;
+      for(size_t i=size_t(mix(key))&mask; ; i=(i+1)&mask) {
+        auto& s = slot[i];
+        if(s.val==Empty) {
+          s.key = key;
+          s.val = val;
+          ++count;
+          return val;
+          }
+        if(s.key==key)
+          return s.val;
+        }
+      }
+
+  private:
+    enum : uint32_t { Empty = uint32_t(-1) };
+
+    struct Slot final {
+      uint64_t key = 0;
+      uint32_t val = Empty;
+      };
+
+    static uint64_t mix(uint64_t h) {
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdull;
+      h ^= h >> 33;
+      h *= 0xc4ceb9fe1a85ec53ull;
+      h ^= h >> 33;
+      return h;
+      }
+
+    void grow() {
+      std::vector<Slot> prev(slot.size()*2);
+      prev.swap(slot);
+      const size_t mask = slot.size()-1;
+      for(auto& p:prev) {
+        if(p.val==Empty)
+          continue;
+        size_t i = size_t(mix(p.key))&mask;
+        while(slot[i].val!=Empty)
+          i = (i+1)&mask;
+        slot[i] = p;
+        }
+      }
+
+    std::vector<Slot> slot;
+    size_t            count = 0;
+  };
+
+}
+
+PackedMesh PackedMesh::baked(std::string_view name, const ZenLoad::zCMesh& mesh, PkgType type) {
+  char key[16] = {};
+  std::snprintf(key,sizeof(key),"%d",int(type));
+
+  std::vector<uint8_t> data;
+  if(Resources::readBaked(name,key,data)) {
+    PackedMesh ret;
+    if(ret.deserialize(data))
+      return ret;
+    Log::e("baked world cache is corrupted: \"",std::string(name),":",key,"\"");
+    }
+
+  PackedMesh ret(mesh,type);
+  data.clear();
+  ret.serialize(data);
+  Resources::writeBaked(name,key,data);
+  return ret;
+  }
+
+void PackedMesh::serialize(std::vector<uint8_t>& out) const {
+  BakeWriter wr{out};
+  wr.write(BakeVersion);
+  wr.write(bbox);
+  wr.write(vertices);
+  wr.write(uint32_t(subMeshes.size()));
+  for(auto& i:subMeshes) {
+    // only fields, used by landscape and physics
+    auto& m = i.material;
+    wr.write(m.matName);
+    wr.write(m.texture);
+    wr.write(m.texAniMapDir);
+    wr.write(m.matGroup);
+    wr.write(m.alphaFunc);
+    wr.write(m.texAniMapMode);
+    wr.write(m.texAniFPS);
+    wr.write(m.noCollDet);
+    wr.write(i.indices);
+    }
+  }
+
+bool PackedMesh::deserialize(const std::vector<uint8_t>& in) {
+  BakeReader rd{in};
+  uint32_t   ver = 0, count = 0;
+  if(!rd.read(ver) || ver!=BakeVersion)
+    return false;
+  if(!rd.read(bbox) || !rd.read(vertices) || !rd.read(count))
+    return false;
+  subMeshes.resize(count);
+  for(auto& i:subMeshes) {
+    auto& m = i.material;
+    if(!rd.read(m.matName) || !rd.read(m.texture) || !rd.read(m.texAniMapDir) ||
+       !rd.read(m.matGroup) || !rd.read(m.alphaFunc) || !rd.read(m.texAniMapMode) ||
+       !rd.read(m.texAniFPS) || !rd.read(m.noCollDet) || !rd.read(i.indices))
+      return false;
+    }
+  return rd.at==in.size();
+  }
+
 PackedMesh::PackedMesh(const ZenLoad::zCMesh& mesh, PkgType type) {
   mesh.getBoundingBox(bbox[0],bbox[1]);
   if(type==PK_Visual || type==PK_VisualLnd) {
@@ -62,13 +262,8 @@ void PackedMesh::pack(const ZenLoad::zCMesh& mesh,PkgType type) {
       });
     }
 
-  struct Hash final {
-    size_t operator() (const std::pair<uint32_t,uint32_t>& v) const noexcept {
-      return v.first^v.second;
-      }
-    };
-  std::unordered_map<std::pair<uint32_t,uint32_t>,size_t,Hash> icache;
-  auto& mid = mesh.getTriangleMaterialIndices();
+  WeldTable icache(vbo.size());
+  auto&     mid = mesh.getTriangleMaterialIndices();
 
   for(size_t i=0;i<ibo.size();++i) {
     size_t id    = size_t(mid[i/3]);
@@ -82,24 +277,21 @@ void PackedMesh::pack(const ZenLoad::zCMesh& mesh,PkgType type) {
       continue;
     auto& s = subMeshes[matId];
 
-    std::pair<uint32_t,uint32_t> index={ibo[i], (type==PK_Physic ? 0 : uv[i])};
-    auto r = icache.find(index);
-    if(r!=icache.end()) {
-      s.indices.push_back(uint32_t(r->second));
-      } else {
-      auto&       v  = mesh.getFeatures()[index.second];
+    const uint32_t vId = uint32_t(ibo[i]);
+    const uint32_t fId = (type==PK_Physic ? 0 : uint32_t(uv[i]));
+    const uint32_t val = icache.insert((uint64_t(vId)<<32) | fId, uint32_t(vertices.size()));
+    if(val==vertices.size()) {
+      auto&       v  = mesh.getFeatures()[fId];
       WorldVertex vx = {};
 
-      vx.Position = vbo[index.first];
+      vx.Position = vbo[vId];
       vx.Normal   = v.vertNormal;
       vx.TexCoord = ZMath::float2(v.uv[0], v.uv[1]);
       vx.Color    = v.lightStat;
 
-      size_t val = vertices.size();
       vertices.emplace_back(vx);
-      s.indices.push_back(uint32_t(val));
-      icache[index] = uint32_t(val);
       }
+    s.indices.push_back(val);
     }
   }
 
@@ -170,22 +362,97 @@ void PackedMesh::landRepack() {
   subMeshes = std::move(m);
   }
 
+// cell of a uniform grid; triangles are binned by centroid
+static const float  blockSz    = 40*100;
+// clusters smaller than that are merged with adjacent ones, to not produce micro-meshes
+static const size_t minCluster = 64*100;
+// micro-mesh is kept whole only, if it's that compact
+static const float  maxSparse  = 4*blockSz;
+
 void PackedMesh::split(std::vector<SubMesh>& out, SubMesh& src) {
-  static bool avoidMicroMeshes = true;
-  if(avoidMicroMeshes && src.indices.size()<64*100) {
-    if(src.indices.size()>0)
-      out.push_back(std::move(src));
+  struct Cluster final {
+    int32_t               cell[3] = {};
+    std::vector<uint32_t> indices;
+    };
+
+  if(src.indices.size()<minCluster) {
+    splitBisect(out,src);
     return;
     }
 
+  std::map<std::tuple<int32_t,int32_t,int32_t>,size_t> cellId;
+  std::vector<Cluster>                                   cluster;
+  for(size_t i=0; i<src.indices.size(); i+=3) {
+    auto& a = vertices[src.indices[i+0]].Position;
+    auto& b = vertices[src.indices[i+1]].Position;
+    auto& c = vertices[src.indices[i+2]].Position;
+
+    const auto x = int32_t(std::floor((a.x+b.x+c.x)/(3.f*blockSz)));
+    const auto y = int32_t(std::floor((a.y+b.y+c.y)/(3.f*blockSz)));
+    const auto z = int32_t(std::floor((a.z+b.z+c.z)/(3.f*blockSz)));
+
+    auto ins = cellId.emplace(std::make_tuple(x,y,z),cluster.size());
+    if(ins.second) {
+      cluster.emplace_back();
+      cluster.back().cell[0] = x;
+      cluster.back().cell[1] = y;
+      cluster.back().cell[2] = z;
+      }
+    auto& dest = cluster[ins.first->second].indices;
+    dest.insert(dest.end(),src.indices.begin()+int(i),src.indices.begin()+int(i+3));
+    }
+
+  if(cluster.size()==1) {
+    out.push_back(std::move(src));
+    return;
+    }
+
+  std::vector<size_t> big;
+  for(size_t i=0; i<cluster.size(); ++i)
+    if(cluster[i].indices.size()>=minCluster)
+      big.push_back(i);
+
+  // small cells go to the biggest adjacent cluster; the rest is partitioned separately
+  SubMesh rest;
+  rest.material = src.material;
+  for(auto& cl:cluster) {
+    if(cl.indices.size()>=minCluster)
+      continue;
+    size_t nearest = size_t(-1);
+    for(auto id:big) {
+      bool adjacent = true;
+      for(int r=0; r<3; ++r)
+        if(std::abs(cl.cell[r]-cluster[id].cell[r])>1)
+          adjacent = false;
+      if(adjacent && (nearest==size_t(-1) || cluster[id].indices.size()>cluster[nearest].indices.size()))
+        nearest = id;
+      }
+    auto& dest = (nearest==size_t(-1)) ? rest.indices : cluster[nearest].indices;
+    dest.insert(dest.end(),cl.indices.begin(),cl.indices.end());
+    cl.indices.clear();
+    }
+
+  src.indices.clear();
+  for(auto id:big) {
+    SubMesh sm;
+    sm.material = src.material;
+    sm.indices  = std::move(cluster[id].indices);
+    out.push_back(std::move(sm));
+    }
+  splitBisect(out,rest);
+  }
+
+void PackedMesh::splitBisect(std::vector<SubMesh>& out, SubMesh& src) {
+  if(src.indices.size()==0)
+    return;
+
   Bounds bbox;
   bbox.assign(vertices,src.indices);
   Vec3 sz = bbox.bboxTr[1]-bbox.bboxTr[0];
 
-  static const float blockSz = 40*100;
-  if(sz.x<=blockSz && sz.y<=blockSz && sz.z<=blockSz){
-    if(src.indices.size()>0)
-      out.push_back(std::move(src));
+  const float maxSz = (src.indices.size()<minCluster) ? maxSparse : blockSz;
+  if(sz.x<=maxSz && sz.y<=maxSz && sz.z<=maxSz){
+    out.push_back(std::move(src));
     return;
     }
 
@@ -221,11 +488,7 @@ void PackedMesh::split(std::vector<SubMesh>& out, SubMesh& src) {
           break;
         }
       SubMesh& dest = cond ? left : right;
-      size_t i0 = dest.indices.size();
-      dest.indices.resize(dest.indices.size()+3);
-
-      for(size_t r=0;r<3;++r)
-        dest.indices[i0+r] = src.indices[i+r];
+      dest.indices.insert(dest.indices.end(),src.indices.begin()+int(i),src.indices.begin()+int(i+3));
       }
     if((left.indices.size()==0 || right.indices.size()==0) && pass!=2) {
       axis = (axis+1)%3;
@@ -237,8 +500,8 @@ void PackedMesh::split(std::vector<SubMesh>& out, SubMesh& src) {
       return;
       }
     src.indices.clear();
-    split(out,left);
-    split(out,right);
+    splitBisect(out,left);
+    splitBisect(out,right);
     return;
     }
   }
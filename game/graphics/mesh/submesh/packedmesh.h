@@ -5,6 +5,7 @@
 
 #include <unordered_map>
 #include <map>
+#include <string_view>
 
 class Bounds;
 
@@ -32,7 +33,15 @@ class PackedMesh {
     PackedMesh(const ZenLoad::zCMesh& mesh, PkgType type);
     void debug(std::ostream &out) const;
 
+    // same as constructor, but result is restored from baked world cache, if possible
+    static PackedMesh baked(std::string_view name, const ZenLoad::zCMesh& mesh, PkgType type);
+
   private:
+    PackedMesh() = default;
+
+    void   serialize  (std::vector<uint8_t>& out) const;
+    bool   deserialize(const std::vector<uint8_t>& in);
+
     void   pack(const ZenLoad::zCMesh& mesh,PkgType type);
 
     size_t submeshIndex(const ZenLoad::zCMesh& mesh, std::vector<SubMesh*>& index,
@@ -42,6 +51,7 @@ class PackedMesh {
     static bool compare(const ZenLoad::zCMaterialData& l, const ZenLoad::zCMaterialData& r);
 
     void   landRepack();
-    void   split(std::vector<SubMesh>& out, SubMesh& src);
+    void   split      (std::vector<SubMesh>& out, SubMesh& src);
+    void   splitBisect(std::vector<SubMesh>& out, SubMesh& src);
   };
 
@@ -91,6 +91,15 @@ Bounds MeshObjects::Mesh::bounds() const {
   return b;
   }
 
+bool MeshObjects::Mesh::isVisible() const {
+  if(subCount==0)
+    return true; // no view to judge on - treat as visible
+  for(size_t i=0; i<subCount; ++i)
+    if(sub[i].isVisible())
+      return true;
+  return false;
+  }
+
 const PfxEmitterMesh* MeshObjects::Mesh::toMeshEmitter() const {
   if(auto p = proto)
     return Resources::loadEmiterMesh(p->fname.c_str());
@@ -76,6 +76,7 @@ class ObjectsBucket final {
         void   startMMAnim (std::string_view anim, float intensity, uint64_t timeUntil);
 
         const Bounds& bounds() const;
+        bool          isVisible() const;
 
         void   draw(Tempest::Encoder<Tempest::CommandBuffer>& p, uint8_t fId) const;
 
@@ -217,6 +218,7 @@ class ObjectsBucket final {
     void    drawCommon(Tempest::Encoder<Tempest::CommandBuffer>& cmd, uint8_t fId, const Tempest::RenderPipeline& shader, SceneGlobals::VisCamera c);
 
     const Bounds& bounds(size_t i) const;
+    bool          isVisible(size_t i) const;
 
     VisualObjects&            owner;
     Descriptors               uboShared;
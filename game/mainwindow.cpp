@@ -599,8 +599,10 @@ void MainWindow::drawSaving(Painter &p) {
 void MainWindow::drawSaving(Painter& p, int sw, int sh, float scale) {
   const int x = (w()-sw)/2, y = (h()-sh)/2;
 
-  if(saveback==nullptr)
+  if(saveback==nullptr) {
+    Resources::PinScope pin;
     saveback = Resources::loadTexture("SAVING.TGA");
+    }
   if(saveback==nullptr)
     return;
 
@@ -824,6 +826,8 @@ void MainWindow::onWorldLoaded() {
   device.waitIdle();
   for(auto& c:commands)
     c = device.commandBuffer();
+  // no frames in flight: safe to release assets of previous world
+  Resources::evictUnused();
 
   if(auto c = Gothic::inst().camera())
     c->setViewport(uint32_t(w()),uint32_t(h()));
@@ -884,6 +888,7 @@ void MainWindow::render(){
       tickCamera(dt);
       Gothic::inst().updateAnimation(dt);
       }
+    Resources::uploadPending();
 
     if(video.isActive()) {
       video.paint(device,cmdId);
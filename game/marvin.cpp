@@ -3,6 +3,7 @@
 #include <initializer_list>
 #include <cstdint>
 #include <cctype>
+#include <cstdlib>
 
 #include "world/objects/npc.h"
 #include "camera.h"
@@ -117,6 +118,11 @@ Marvin::Marvin() {
     {"toogle camdebug",   C_ToogleCamDebug},
     {"toogle camera",     C_ToogleCamera},
     {"insert %c",         C_Insert},
+
+    {"toogle scriptprofiler",   C_ToogleScriptProfiler},
+    {"scriptprofiler print %d", C_ScriptProfilerPrint},
+    {"scriptprofiler reset",    C_ScriptProfilerReset},
+    {"scriptprofiler dump %s",  C_ScriptProfilerDump},
     };
   }
 
@@ -261,6 +267,36 @@ bool Marvin::exec(const std::string& v) {
         return false;
       return printVariable(world,ret.argv[0]);
       }
+    case C_ToogleScriptProfiler: {
+      World* world = Gothic::inst().world();
+      if(world==nullptr)
+        return false;
+      auto& p = world->script().scriptProfiler();
+      p.setEnabled(!p.isEnabled());
+      print(p.isEnabled() ? "script profiler: on" : "script profiler: off");
+      return true;
+      }
+    case C_ScriptProfilerPrint: {
+      World* world = Gothic::inst().world();
+      if(world==nullptr)
+        return false;
+      auto topN = std::strtoul(std::string(ret.argv[0]).c_str(),nullptr,10);
+      world->script().scriptProfiler().report(topN,[this](std::string_view s){ print(s); });
+      return true;
+      }
+    case C_ScriptProfilerReset: {
+      World* world = Gothic::inst().world();
+      if(world==nullptr)
+        return false;
+      world->script().scriptProfiler().reset();
+      return true;
+      }
+    case C_ScriptProfilerDump: {
+      World* world = Gothic::inst().world();
+      if(world==nullptr)
+        return false;
+      return world->script().scriptProfiler().dump(std::string(ret.argv[0]));
+      }
     }
 
   return true;
@@ -34,6 +34,12 @@ class Marvin {
       C_ToogleCamera,
 
       C_Insert,
+
+      // script profiler
+      C_ToogleScriptProfiler,
+      C_ScriptProfilerPrint,
+      C_ScriptProfilerReset,
+      C_ScriptProfilerDump,
       };
 
     struct Cmd {
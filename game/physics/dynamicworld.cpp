@@ -1,5 +1,7 @@
 #include "dynamicworld.h"
 
+#include <Tempest/Log>
+
 #include "physics.h"
 
 #include "collisionworld.h"
@@ -9,11 +11,14 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 
 #include "graphics/mesh/submesh/packedmesh.h"
 #include "world/objects/item.h"
 #include "world/bullet.h"
 #include "world/world.h"
+#include "resources.h"
 
 const float DynamicWorld::ghostPadding=50-22.5f;
 const float DynamicWorld::ghostHeight =140;
@@ -398,7 +403,7 @@ DynamicWorld::DynamicWorld(World& owner,const ZenLoad::zCMesh& worldMesh) {
   //solver.reset(new btSequentialImpulseConstraintSolver());
   world.reset(new CollisionWorld());
 
-  PackedMesh pkg(worldMesh,PackedMesh::PK_PhysicZoned);
+  PackedMesh pkg = PackedMesh::baked(owner.name(),worldMesh,PackedMesh::PK_PhysicZoned);
   sectors.resize(pkg.subMeshes.size());
   for(size_t i=0;i<sectors.size();++i)
     sectors[i] = pkg.subMeshes[i].material.matName;
@@ -427,7 +432,7 @@ DynamicWorld::DynamicWorld(World& owner,const ZenLoad::zCMesh& worldMesh) {
   if(!landMesh->isEmpty()) {
     Tempest::Matrix4x4 mt;
     mt.identity();
-    landShape.reset(new btMultimaterialTriangleMeshShape(landMesh.get(),landMesh->useQuantization(),true));
+    landShape.reset(bakedMeshShape(*landMesh,owner,"land",landBvh));
     landBody = world->addCollisionBody(*landShape,mt,DynamicWorld::materialFriction(ZenLoad::NUM_MAT_GROUPS));
     landBody->setUserIndex(C_Landscape);
 
@@ -440,7 +445,7 @@ DynamicWorld::DynamicWorld(World& owner,const ZenLoad::zCMesh& worldMesh) {
   if(!waterMesh->isEmpty()) {
     Tempest::Matrix4x4 mt;
     mt.identity();
-    waterShape.reset(new btMultimaterialTriangleMeshShape(waterMesh.get(),waterMesh->useQuantization(),true));
+    waterShape.reset(bakedMeshShape(*waterMesh,owner,"water",waterBvh));
     waterBody = world->addCollisionBody(*waterShape,mt,0);
     waterBody->setUserIndex(C_Water);
     waterBody->setFlags(btCollisionObject::CF_STATIC_OBJECT | btCollisionObject::CF_NO_CONTACT_RESPONSE);
@@ -469,6 +474,52 @@ DynamicWorld::DynamicWorld(World& owner,const ZenLoad::zCMesh& worldMesh) {
 DynamicWorld::~DynamicWorld(){
   }
 
+btCollisionShape* DynamicWorld::bakedMeshShape(PhysicVbo& mesh, const World& owner, const char* tag,
+                                               std::vector<btVector3>& bvh) {
+  // blob layout: version, mesh hash, serialized btOptimizedBvh
+  static const uint64_t bvhVersion = 1;
+  static const size_t   header     = 2*sizeof(uint64_t);
+
+  char key[64] = {};
+  std::snprintf(key,sizeof(key),"bvh:%s",tag);
+
+  const bool           quantized = mesh.useQuantization();
+  const uint64_t       hash      = mesh.hash();
+  std::vector<uint8_t> data;
+  if(Resources::readBaked(owner.name(),key,data) && data.size()>header) {
+    uint64_t ver = 0, h = 0;
+    std::memcpy(&ver,data.data(),                 sizeof(ver));
+    std::memcpy(&h,  data.data()+sizeof(uint64_t),sizeof(h));
+    if(ver==bvhVersion && h==hash) {
+      const size_t size = data.size()-header;
+      bvh.resize((size+sizeof(btVector3)-1)/sizeof(btVector3));
+      std::memcpy(bvh.data(),data.data()+header,size);
+      if(auto tree = btOptimizedBvh::deSerializeInPlace(bvh.data(),unsigned(size),false)) {
+        auto shape = new btMultimaterialTriangleMeshShape(&mesh,quantized,false);
+        shape->setOptimizedBvh(tree);
+        return shape;
+        }
+      }
+    // stale blob: rebuilt tree below replaces it in the cache
+    Tempest::Log::i("baked collision is outdated: \"",owner.name(),":",key,"\"");
+    bvh.clear();
+    }
+
+  auto shape = new btMultimaterialTriangleMeshShape(&mesh,quantized,true);
+  if(auto tree = shape->getOptimizedBvh()) {
+    const unsigned         size = tree->calculateSerializeBufferSize();
+    std::vector<btVector3> tmp((size+sizeof(btVector3)-1)/sizeof(btVector3));
+    if(tree->serializeInPlace(tmp.data(),size,false)) {
+      data.resize(header+size);
+      std::memcpy(data.data(),                 &bvhVersion,sizeof(bvhVersion));
+      std::memcpy(data.data()+sizeof(uint64_t),&hash,      sizeof(hash));
+      std::memcpy(data.data()+header,          tmp.data(), size);
+      Resources::writeBaked(owner.name(),key,data);
+      }
+    }
+  return shape;
+  }
+
 DynamicWorld::RayLandResult DynamicWorld::landRay(const Tempest::Vec3& from, float maxDy) const {
   world->updateAabbs();
   if(maxDy==0)
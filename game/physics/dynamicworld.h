@@ -252,6 +252,8 @@ class DynamicWorld final {
       };
     Item           createObj(btCollisionShape* shape, bool ownShape, const Tempest::Matrix4x4& m,
                              float mass, float friction, ItemType type);
+    auto           bakedMeshShape(PhysicVbo& mesh, const World& owner, const char* tag,
+                                  std::vector<btVector3>& bvh) -> btCollisionShape*;
 
 
     void           moveBullet(BulletBody& b, const Tempest::Vec3& dir, uint64_t dt);
@@ -262,6 +264,10 @@ class DynamicWorld final {
 
     std::vector<std::string>           sectors;
 
+    // storage of deserialized BVH trees (btVector3 - for 16-byte alignment), must outlive shapes
+    std::vector<btVector3>             landBvh;
+    std::vector<btVector3>             waterBvh;
+
     std::vector<btVector3>             landVbo;
     std::unique_ptr<PhysicVbo>         landMesh;
     std::unique_ptr<btCollisionShape>  landShape;
@@ -1,5 +1,7 @@
 #include "physicvbo.h"
 
+#include <cstring>
+
 #include "collisionworld.h"
 
 PhysicVbo::PhysicVbo(ZenLoad::PackedMesh&& sPacked)
@@ -96,6 +98,36 @@ bool PhysicVbo::isEmpty() const {
   return segments.size()==0;
   }
 
+uint64_t PhysicVbo::hash() const {
+  uint64_t h   = 0xcbf29ce484222325ull;
+  auto     mix = [&h](uint64_t v) {
+    h ^= v;
+    h *= 0x100000001b3ull;
+    };
+  auto     mixF = [&mix](float f) {
+    uint32_t u = 0;
+    std::memcpy(&u,&f,sizeof(u));
+    mix(u);
+    };
+
+  mix(vert.size());
+  for(auto& v:vert) {
+    mixF(v.x());
+    mixF(v.y());
+    mixF(v.z());
+    }
+  mix(id.size());
+  for(auto i:id)
+    mix(i);
+  mix(segments.size());
+  for(auto& sg:segments) {
+    mix(sg.off);
+    mix(uint64_t(sg.size));
+    mix(sg.mat);
+    }
+  return h;
+  }
+
 void PhysicVbo::adjustMesh(){
   for(int i=0;i<m_indexedMeshes.size();++i){
     btIndexedMesh& meshIndex=m_indexedMeshes[i];
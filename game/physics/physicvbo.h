@@ -21,6 +21,8 @@ class PhysicVbo : public btTriangleIndexVertexArray {
     auto    sectorName(size_t segment) const -> const char*;
     bool    useQuantization() const;
     bool    isEmpty() const;
+    // content hash of vertices, indices and segments: validates baked BVH
+    uint64_t hash() const;
 
     void    adjustMesh();
 
@@ -18,6 +18,8 @@
 #include <zenload/ztex2dds.h>
 
 #include <fstream>
+#include <algorithm>
+#include <cctype>
 
 #include "graphics/mesh/submesh/staticmesh.h"
 #include "graphics/mesh/submesh/animmesh.h"
@@ -25,6 +27,8 @@
 #include "graphics/mesh/skeleton.h"
 #include "graphics/mesh/protomesh.h"
 #include "graphics/mesh/animation.h"
+#include "graphics/mesh/animationsolver.h"
+#include "graphics/mesh/pose.h"
 #include "graphics/mesh/attachbinder.h"
 #include "graphics/material.h"
 #include "physics/physicmeshshape.h"
@@ -39,6 +43,10 @@ using namespace Tempest;
 
 Resources* Resources::inst=nullptr;
 
+static thread_local uint32_t pinDepth = 0;
+// background loader: its requests are prefetches or follow-ups of recorded requests - not part of manifest
+static thread_local bool     asyncWorker = false;
+
 static void emplaceTag(char* buf, char tag){
   for(size_t i=1;buf[i];++i){
     if(buf[i]==tag && buf[i-1]=='_' && buf[i+1]=='0'){
@@ -50,10 +58,47 @@ static void emplaceTag(char* buf, char tag){
     }
   }
 
+// limits amount of background-decoded textures, uploaded in one frame
+static const size_t MaxUploadPerFrame = 16*1024*1024;
+
+// manifest line tags
+static const char MfTexture   = 'T';
+static const char MfMesh      = 'M';
+static const char MfAnimation = 'A';
+
+static size_t textureSize(const Texture2d& t) {
+  return size_t(t.w())*size_t(t.h())*4;
+  }
+
+static size_t meshSize(const ProtoMesh& m) {
+  size_t ret = 0;
+  for(auto& i:m.attach)
+    ret += i.vbo.size()*sizeof(Resources::Vertex)  + i.ibo.size()*sizeof(uint32_t);
+  for(auto& i:m.skined)
+    ret += i.vbo.size()*sizeof(Resources::VertexA) + i.ibo.size()*sizeof(uint32_t);
+  return ret;
+  }
+
+static size_t animationSize(const Animation& a) {
+  return a.memoryUsage();
+  }
+
+static void collectTextures(const Material& m, std::vector<const void*>& out) {
+  if(m.tex!=nullptr)
+    out.push_back(m.tex);
+  for(auto i:m.frames)
+    out.push_back(i);
+  }
+
 Resources::Resources(Tempest::Device &device)
-  : dev(device) {
+  : dev(device), texCache(textureSize), aniMeshCache(meshSize), animCache(animationSize) {
   inst=this;
 
+  const int texBudget = Gothic::settingsGetI("ENGINE","zTexCacheSizeMaxBytes");
+  const int mdlBudget = Gothic::settingsGetI("ENGINE","zMdlCacheSizeMaxBytes");
+  gpuBudget = texBudget>0 ? size_t(texBudget) : size_t(512*1024*1024);
+  cpuBudget = mdlBudget>0 ? size_t(mdlBudget) : size_t(256*1024*1024);
+
   ZenLib::Log::SetLogCallback([](ZenLib::Log::EMessageType t, const char* what) {
     switch(t) {
       case ZenLib::Log::EMessageType::MT_Error:
@@ -86,9 +131,6 @@ Resources::Resources(Tempest::Device &device)
   dxMusic->addPath(Gothic::inst().nestedPath({u"_work",u"Data",u"Music",u"menu_men"}, Dir::FT_Dir));
   dxMusic->addPath(Gothic::inst().nestedPath({u"_work",u"Data",u"Music",u"orchestra"},Dir::FT_Dir));
 
-  fBuff .reserve(8*1024*1024);
-  ddsBuf.reserve(8*1024*1024);
-
   {
   Pixmap pm(1,1,Pixmap::Format::RGBA);
   uint8_t* pix = reinterpret_cast<uint8_t*>(pm.data());
@@ -113,9 +155,15 @@ Resources::Resources(Tempest::Device &device)
            std::make_tuple(bIsMod,b.time,int(b.ord));
     });
 
-  for(auto& i:archives)
+  for(auto& i:archives) {
     gothicAssets.loadVDF(i.name);
+    mappedAssets.load(i.name);
+    }
   gothicAssets.finalizeLoad();
+  mappedAssets.finalizeLoad();
+  // converted ZTEX textures, valid until any of archives is changed
+  texDiskCache  .reset(new DiskCache("texture.cache",fingerprint(archives)));
+  worldDiskCache.reset(new DiskCache("world.cache",  fingerprint(archives)));
 
   //for(auto& i:gothicAssets.getKnownFiles())
   //  Log::i(i);
@@ -123,14 +171,80 @@ Resources::Resources(Tempest::Device &device)
   // auto v = getFileData("DRAGONISLAND.ZEN");
   // Tempest::WFile f("../../internal/DRAGONISLAND.ZEN");
   // f.write(v.data(),v.size());
+
+  // small pool: prefetch of many assets at once shouldn't starve game thread
+  const unsigned thCount = std::max(1u,std::min(4u,std::thread::hardware_concurrency()/2));
+  for(unsigned i=0; i<thCount; ++i)
+    asyncTh.emplace_back([this]() noexcept {
+      asyncThreadFunc();
+      });
   }
 
 Resources::~Resources() {
+  {
+  std::lock_guard<std::mutex> g(asyncSync);
+  asyncRunning = false;
+  asyncQueue.clear();
+  }
+  asyncWait.notify_all();
+  for(auto& th:asyncTh)
+    th.join();
   inst=nullptr;
   }
 
+void Resources::asyncThreadFunc() {
+  asyncWorker = true;
+  while(true) {
+    std::function<void()> task;
+    {
+    std::unique_lock<std::mutex> g(asyncSync);
+    asyncWait.wait(g,[this](){ return !asyncRunning || !asyncQueue.empty(); });
+    if(!asyncRunning)
+      return;
+    task = std::move(asyncQueue.front());
+    asyncQueue.pop_front();
+    asyncBusy++;
+    }
+    task();
+    std::lock_guard<std::mutex> g(asyncSync);
+    asyncBusy--;
+    if(asyncBusy==0 && asyncQueue.empty())
+      asyncIdle.notify_all();
+    }
+  }
+
+void Resources::implDrainAsync() {
+  std::unique_lock<std::mutex> g(asyncSync);
+  asyncIdle.wait(g,[this](){ return !asyncRunning || (asyncBusy==0 && asyncQueue.empty()); });
+  }
+
+template<class T, class F>
+std::shared_future<T> Resources::implLoadAsync(AsyncCache<T>& cache, std::string_view name, F load) {
+  std::lock_guard<std::mutex> g(asyncSync);
+  auto cname = std::string(name);
+  auto it    = cache.find(cname);
+  if(it!=cache.end())
+    return it->second;
+
+  auto task = std::make_shared<std::packaged_task<T()>>([load,cname]() -> T {
+    try {
+      return load(cname);
+      }
+    catch(...) {
+      Log::e("unable to load \"",cname,"\"");
+      return nullptr;
+      }
+    });
+  auto ret = task->get_future().share();
+  cache[cname] = ret;
+  asyncQueue.emplace_back([task](){ (*task)(); });
+  asyncWait.notify_one();
+  return ret;
+  }
+
 bool Resources::hasFile(std::string_view name) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
+  if(!inst->mappedAssets.find(name).isEmpty())
+    return true;
   if(name.size()<128) {
     char buf[128] = {};
     std::snprintf(buf,sizeof(buf),"%.*s",int(name.size()),name.data());
@@ -141,6 +255,11 @@ bool Resources::hasFile(std::string_view name) {
 
 bool Resources::getFileData(std::string_view name, std::vector<uint8_t> &dat) {
   dat.clear();
+  auto view = inst->mappedAssets.find(name);
+  if(!view.isEmpty()) {
+    dat.assign(view.data,view.data+view.size);
+    return true;
+    }
   if(name.size()<128) {
     char buf[128] = {};
     std::snprintf(buf,sizeof(buf),"%.*s",int(name.size()),name.data());
@@ -149,6 +268,10 @@ bool Resources::getFileData(std::string_view name, std::vector<uint8_t> &dat) {
   return inst->gothicAssets.getFileData(std::string(name),dat);
   }
 
+MappedArchive::View Resources::getFileView(std::string_view name) {
+  return inst->mappedAssets.find(name);
+  }
+
 std::vector<uint8_t> Resources::getFileData(std::string_view name) {
   std::vector<uint8_t> data;
   getFileData(name,data);
@@ -223,6 +346,311 @@ VDFS::FileIndex& Resources::vdfsIndex() {
   return inst->gothicAssets;
   }
 
+std::string Resources::worldKey(std::string_view zen) {
+  size_t cut = zen.find_last_of("\\/");
+  if(cut!=std::string_view::npos)
+    zen = zen.substr(cut+1);
+  std::string ret;
+  for(auto c:zen)
+    ret.push_back(char(std::tolower(c)));
+  return ret;
+  }
+
+std::string Resources::bakedKey(std::string_view world, std::string_view tag) {
+  std::string ret = worldKey(world);
+  ret += ':';
+  ret.append(tag.data(),tag.size());
+  return ret;
+  }
+
+bool Resources::readBaked(std::string_view world, std::string_view tag, std::vector<uint8_t>& out) {
+  const auto key = bakedKey(world,tag);
+  {
+  std::lock_guard<std::mutex> g(inst->asyncSync);
+  auto it = inst->preloadBaked.find(key);
+  if(it!=inst->preloadBaked.end()) {
+    out = std::move(it->second);
+    inst->preloadBaked.erase(it);
+    return true;
+    }
+  }
+  return inst->worldDiskCache->read(key,out);
+  }
+
+void Resources::preloadWorld(std::string_view zen) {
+  inst->implPreloadWorld(zen);
+  }
+
+void Resources::cancelPreload(std::string_view zen) {
+  std::lock_guard<std::mutex> g(inst->asyncSync);
+  if(zen.empty() || inst->preloadName==worldKey(zen)) {
+    inst->preloadName.clear();
+    inst->preloadBaked.clear();
+    }
+  }
+
+void Resources::implPreloadWorld(std::string_view zen) {
+  const std::string name = worldKey(zen);
+  if(name.empty() || !hasFile(name))
+    return;
+
+  {
+  std::lock_guard<std::mutex> g(asyncSync);
+  if(preloadName==name)
+    return;
+  preloadName = name;
+  preloadBaked.clear();
+
+  asyncQueue.emplace_back([this,name]() {
+    // warm-up page cache for zen parser
+    auto view = getFileView(name);
+    uint8_t acc = 0;
+    for(size_t i=0; i<view.size; i+=4096)
+      acc = uint8_t(acc ^ view.data[i]);
+    static volatile uint8_t sink = 0;
+    sink = acc;
+
+    for(auto& key:worldDiskCache->keys(bakedKey(name,""))) {
+      {
+      std::lock_guard<std::mutex> g(asyncSync);
+      if(preloadName!=name)
+        return;
+      }
+      std::vector<uint8_t> data;
+      if(!worldDiskCache->read(key,data))
+        continue;
+      std::lock_guard<std::mutex> g(asyncSync);
+      if(preloadName!=name)
+        return;
+      preloadBaked[key] = std::move(data);
+      }
+    });
+  asyncWait.notify_one();
+  }
+
+  Log::i("preload: \"",name,"\"");
+  implPrefetchManifest(name);
+  }
+
+void Resources::writeBaked(std::string_view world, std::string_view tag, const std::vector<uint8_t>& data) {
+  inst->worldDiskCache->write(bakedKey(world,tag),data);
+  }
+
+Resources::PinScope::PinScope() {
+  pinDepth++;
+  }
+
+Resources::PinScope::~PinScope() {
+  pinDepth--;
+  }
+
+bool Resources::isPinning() {
+  // everything before first world is UI and global data
+  return pinDepth>0 || inst->cacheEpoch==0;
+  }
+
+void Resources::beginWorldLoad() {
+  std::lock_guard<std::recursive_mutex> g(inst->sync);
+  inst->cacheEpoch++;
+  inst->evictPending = true;
+  inst->texCache    .setEpoch(inst->cacheEpoch);
+  inst->aniMeshCache.setEpoch(inst->cacheEpoch);
+  inst->animCache   .setEpoch(inst->cacheEpoch);
+  }
+
+void Resources::evictUnused() {
+  // world is loaded: preloaded data, not consumed by it, belongs to a world, that player didn't enter
+  cancelPreload("");
+  // background tasks insert into caches, that are about to be evicted
+  inst->implDrainAsync();
+
+  std::lock_guard<std::recursive_mutex> g(inst->sync);
+  if(!inst->evictPending)
+    return;
+  inst->evictPending = false;
+  inst->implEvictUnused();
+  }
+
+void Resources::implEvictUnused() {
+  // all world objects re-request assets on load, so anything not requested in current epoch
+  // has no owner anymore; textures get one extra epoch of grace for UI, that outlives a world
+  const uint32_t epoch = cacheEpoch;
+  const uint32_t grace = epoch>1 ? epoch-1 : epoch;
+
+  std::vector<std::unique_ptr<ProtoMesh>> meshes;
+  const size_t texUsage  = texCache.memoryUsage();
+  const size_t meshUsage = aniMeshCache.evict(epoch, gpuBudget>texUsage ? gpuBudget-texUsage : 0,
+                                              [](const ProtoMesh*){ return false; }, meshes);
+
+  // survivors keep their dependencies alive
+  std::vector<const void*> used;
+  std::vector<const void*> evicted;
+  auto collect = [&used](const ProtoMesh& m) {
+    for(auto& i:m.attach)
+      for(auto& s:i.sub)
+        collectTextures(s.material,used);
+    for(auto& i:m.skined)
+      for(auto& s:i.sub)
+        collectTextures(s.material,used);
+    if(m.skeleton!=nullptr && m.skeleton->animation()!=nullptr)
+      used.push_back(m.skeleton->animation());
+    };
+  for(auto& i:decalMeshCache)
+    collect(*i.second);
+  aniMeshCache.forEach(collect);
+  std::sort(used.begin(),used.end());
+
+  auto isUsed = [&used](const void* p) {
+    return std::binary_search(used.begin(),used.end(),p);
+    };
+
+  std::vector<std::unique_ptr<Animation>> anims;
+  animCache.evict(epoch,cpuBudget,isUsed,anims);
+
+  std::vector<std::unique_ptr<Texture2d>> tex;
+  texCache.evict(grace,gpuBudget>meshUsage ? gpuBudget-meshUsage : 0,isUsed,tex);
+
+  if(meshes.empty() && anims.empty() && tex.empty())
+    return;
+
+  std::vector<const Skeleton*> skeletons;
+  for(auto& i:meshes) {
+    evicted.push_back(i.get());
+    if(i->skeleton!=nullptr) {
+      evicted.push_back(i->skeleton.get());
+      skeletons.push_back(i->skeleton.get());
+      }
+    }
+  for(auto& i:anims)
+    evicted.push_back(i.get());
+  std::sort(evicted.begin(),evicted.end());
+
+  for(auto it=bindCache.begin(); it!=bindCache.end();) {
+    auto sk = std::get<0>(it->first);
+    auto pm = std::get<1>(it->first);
+    if(std::binary_search(evicted.begin(),evicted.end(),static_cast<const void*>(sk)) ||
+       std::binary_search(evicted.begin(),evicted.end(),static_cast<const void*>(pm)))
+      it = bindCache.erase(it); else
+      ++it;
+    }
+  {
+  std::lock_guard<std::mutex> g(asyncSync);
+  dropAsync(asyncMesh,    evicted);
+  dropAsync(asyncSkeleton,evicted);
+  dropAsync(asyncAnim,    evicted);
+  }
+  AnimationSolver::dropTables(skeletons);
+  Pose::dropSharedPoses();
+
+  Log::i("resources: evicted ",meshes.size()," meshes, ",anims.size()," animations, ",tex.size()," textures");
+  }
+
+void Resources::beginManifest(std::string_view world) {
+  inst->implBeginManifest(world);
+  }
+
+void Resources::endManifest(std::string_view world) {
+  inst->implEndManifest(world);
+  }
+
+std::string Resources::manifestPath(std::string_view world) {
+  size_t beg = world.find_last_of("\\/");
+  world = world.substr(beg==std::string_view::npos ? 0 : beg+1);
+  world = world.substr(0,world.rfind('.'));
+
+  std::string ret;
+  for(auto c:world)
+    ret.push_back(char(std::tolower(c)));
+  ret += ".prefetch";
+  return ret;
+  }
+
+void Resources::implBeginManifest(std::string_view world) {
+  {
+  std::lock_guard<std::mutex> g(manifestSync);
+  manifestWorld = std::string(world);
+  manifest.clear();
+  manifestRec.store(true);
+  }
+  implPrefetchManifest(world);
+  }
+
+void Resources::implPrefetchManifest(std::string_view world) {
+  const auto path = manifestPath(world);
+
+  std::vector<std::string> lines;
+  {
+  std::ifstream fin(path);
+  std::string   ln;
+  while(std::getline(fin,ln))
+    if(ln.size()>2 && ln[1]==' ')
+      lines.push_back(std::move(ln));
+  }
+
+  // meshes first: they are slowest to load, textures are decoded in between
+  std::stable_sort(lines.begin(),lines.end(),[](const std::string& l, const std::string& r){
+    return (l[0]==MfMesh ? 0 : 1) < (r[0]==MfMesh ? 0 : 1);
+    });
+  for(auto& ln:lines) {
+    auto name = std::string_view(ln).substr(2);
+    switch(ln[0]) {
+      case MfTexture:
+        prefetchTexture(name);
+        break;
+      case MfMesh:
+        implLoadMeshAsync(name);
+        break;
+      case MfAnimation:
+        implLoadAnimationAsync(name);
+        break;
+      }
+    }
+  if(!lines.empty())
+    Log::i("prefetch: ",int(lines.size())," assets from \"",path,"\"");
+  }
+
+void Resources::implEndManifest(std::string_view world) {
+  std::lock_guard<std::mutex> g(manifestSync);
+  if(!manifestRec.load() || manifestWorld!=world)
+    return;
+  manifestRec.store(false);
+
+  const auto    path = manifestPath(world);
+  std::ofstream fout(path);
+  if(!fout.is_open()) {
+    Log::e("unable to write prefetch manifest: \"",path,"\"");
+    return;
+    }
+  for(auto& ln:manifest)
+    fout << ln << '\n';
+  manifest.clear();
+  }
+
+void Resources::record(char type, std::string_view name) {
+  if(!manifestRec.load(std::memory_order_relaxed) || asyncWorker || name.empty())
+    return;
+  std::string ln;
+  ln.reserve(name.size()+2);
+  ln.push_back(type);
+  ln.push_back(' ');
+  ln.append(name);
+
+  std::lock_guard<std::mutex> g(manifestSync);
+  if(manifestRec.load())
+    manifest.insert(std::move(ln));
+  }
+
+template<class T>
+void Resources::dropAsync(AsyncCache<T>& cache, const std::vector<const void*>& evicted) {
+  for(auto it=cache.begin(); it!=cache.end();) {
+    auto& f = it->second;
+    if(f.wait_for(std::chrono::seconds(0))==std::future_status::ready &&
+       std::binary_search(evicted.begin(),evicted.end(),static_cast<const void*>(f.get())))
+      it = cache.erase(it); else
+      ++it;
+    }
+  }
+
 const Tempest::VertexBuffer<Resources::VertexFsq> &Resources::fsqVbo() {
   return inst->fsq;
   }
@@ -250,69 +678,125 @@ int64_t Resources::vdfTimestamp(const std::u16string& name) {
     }
   }
 
-Tempest::Texture2d* Resources::implLoadTexture(TextureCache& cache, std::string_view cname) {
-  if(cname.empty())
+uint64_t Resources::fingerprint(const std::vector<Archive>& archives) {
+  uint64_t h = 0xcbf29ce484222325ull;
+  auto     mix = [&h](uint64_t v) {
+    h ^= v;
+    h *= 0x100000001b3ull;
+    };
+  for(auto& i:archives) {
+    for(auto c:i.name)
+      mix(c);
+    mix(uint64_t(i.time));
+    }
+  return h;
+  }
+
+std::unique_ptr<Texture2d> Resources::implLoadTexture(std::string_view cname) {
+  std::shared_future<std::shared_ptr<Pixmap>> pending;
+  {
+  std::lock_guard<std::mutex> g(asyncSync);
+  auto name = std::string(cname);
+  auto it   = asyncTexture.find(name);
+  if(it!=asyncTexture.end()) {
+    // prefetch can be still in queue - decoding it here is faster, than waiting
+    if(it->second.wait_for(std::chrono::seconds(0))==std::future_status::ready ||
+       !asyncTexClaimed.insert(name).second)
+      pending = std::move(it->second);
+    asyncTexture.erase(it);
+    }
+  }
+
+  std::shared_ptr<Pixmap> pm;
+  if(pending.valid())
+    pm = pending.get();
+  if(pm==nullptr)
+    pm = implDecodeTexture(cname);
+  if(pm==nullptr)
     return nullptr;
+  return std::unique_ptr<Texture2d>{new Texture2d(dev.loadTexture(*pm))};
+  }
 
-  std::string name = std::string(cname);
-  auto it=cache.find(name);
-  if(it!=cache.end())
-    return it->second.get();
+std::shared_ptr<Pixmap> Resources::implDecodeTexture(std::string_view cname) {
+  // scratch buffers, reused by each loading thread
+  thread_local std::vector<uint8_t> fBuff, ddsBuf;
 
+  std::string name = std::string(cname);
   if(FileExt::hasExt(name,"TGA")){
     name.resize(name.size()+2);
     std::memcpy(&name[0]+name.size()-6,"-C.TEX",6);
     if(hasFile(name)) {
-      if(!getFileData(name.c_str(),fBuff)) {
-        Log::e("unable to load texture \"",name,"\"");
-        return nullptr;
+      const bool cached = texDiskCache->read(name,ddsBuf);
+      if(!cached) {
+        if(!getFileData(name.c_str(),fBuff)) {
+          Log::e("unable to load texture \"",name,"\"");
+          return nullptr;
+          }
+        ddsBuf.clear();
+        ZenLoad::convertZTEX2DDS(fBuff,ddsBuf);
         }
-      ddsBuf.clear();
-      ZenLoad::convertZTEX2DDS(fBuff,ddsBuf);
-      auto t = implLoadTexture(cache,std::string(cname),ddsBuf);
-      if(t!=nullptr) {
-        return t;
+      auto pm = implDecodeTexture(ddsBuf.data(),ddsBuf.size());
+      if(pm!=nullptr) {
+        if(!cached)
+          texDiskCache->write(name,ddsBuf);
+        return pm;
         }
       }
     }
 
+  auto view = getFileView(cname);
+  if(!view.isEmpty())
+    return implDecodeTexture(view.data,view.size);
   if(getFileData(cname,fBuff))
-    return implLoadTexture(cache,std::string(cname),fBuff);
-
-  cache[name]=nullptr;
+    return implDecodeTexture(fBuff.data(),fBuff.size());
   return nullptr;
   }
 
-Texture2d *Resources::implLoadTexture(TextureCache& cache, std::string&& name, const std::vector<uint8_t> &data) {
+std::shared_ptr<Pixmap> Resources::implDecodeTexture(const uint8_t* data, size_t size) {
   try {
-    Tempest::MemReader rd(data.data(),data.size());
-    Tempest::Pixmap    pm(rd);
-
-    std::unique_ptr<Texture2d> t{new Texture2d(dev.loadTexture(pm))};
-    Texture2d* ret=t.get();
-    cache[std::move(name)] = std::move(t);
-    return ret;
+    Tempest::MemReader rd(data,size);
+    return std::make_shared<Pixmap>(rd);
     }
   catch(...){
     return nullptr;
     }
   }
 
-ProtoMesh* Resources::implLoadMesh(std::string_view name) {
-  if(name.size()==0)
-    return nullptr;
+bool Resources::claimTexture(const std::string& name) {
+  // decoding is taken by whoever comes first: prefetch task or synchronous load
+  std::lock_guard<std::mutex> g(asyncSync);
+  if(asyncTexClaimed.insert(name).second)
+    return true;
+  asyncTexClaimed.erase(name);
+  return false;
+  }
 
-  auto cname = std::string(name);
-  auto it    = aniMeshCache.find(cname);
-  if(it!=aniMeshCache.end())
-    return it->second.get();
+void Resources::implUploadPending() {
+  std::vector<std::pair<std::string,std::shared_ptr<Pixmap>>> ready;
+  {
+  std::lock_guard<std::mutex> g(asyncSync);
+  size_t bytes = 0;
+  for(auto it=asyncTexture.begin(); it!=asyncTexture.end() && bytes<MaxUploadPerFrame;) {
+    if(it->second.wait_for(std::chrono::seconds(0))!=std::future_status::ready) {
+      ++it;
+      continue;
+      }
+    auto pm = it->second.get();
+    if(pm!=nullptr)
+      bytes += size_t(pm->w())*size_t(pm->h())*4;
+    ready.emplace_back(it->first,std::move(pm));
+    it = asyncTexture.erase(it);
+    }
+  }
 
-  auto  t   = implLoadMeshMain(cname);
-  auto  ret = t.get();
-  aniMeshCache[cname] = std::move(t);
-  if(ret==nullptr)
-    Log::e("unable to load mesh \"",cname,"\"");
-  return ret;
+  for(auto& i:ready) {
+    if(i.second==nullptr)
+      continue;
+    auto& pm = *i.second;
+    texCache.get(i.first,[this,&pm](){
+      return std::unique_ptr<Texture2d>{new Texture2d(dev.loadTexture(pm))};
+      });
+    }
   }
 
 std::unique_ptr<ProtoMesh> Resources::implLoadMeshMain(std::string name) {
@@ -506,13 +990,19 @@ Dx8::PatternList Resources::implLoadDxMusic(std::string_view name) {
   }
 
 Tempest::Sound Resources::implLoadSoundBuffer(std::string_view name) {
+  thread_local std::vector<uint8_t> fBuff;
   if(name.empty())
     return Tempest::Sound();
 
-  if(!getFileData(name,fBuff))
-    return Tempest::Sound();
+  auto view = getFileView(name);
+  if(view.isEmpty()) {
+    if(!getFileData(name,fBuff))
+      return Tempest::Sound();
+    view.data = fBuff.data();
+    view.size = fBuff.size();
+    }
   try {
-    Tempest::MemReader rd(fBuff.data(),fBuff.size());
+    Tempest::MemReader rd(view.data,view.size);
     return Tempest::Sound(rd);
     }
   catch(...) {
@@ -523,6 +1013,7 @@ Tempest::Sound Resources::implLoadSoundBuffer(std::string_view name) {
   }
 
 GthFont &Resources::implLoadFont(std::string_view name, FontType type) {
+  PinScope pin;
   auto cname = std::string(name);
   auto it    = gothicFnt.find(std::make_pair(cname,type));
   if(it!=gothicFnt.end())
@@ -576,8 +1067,12 @@ GthFont &Resources::implLoadFont(std::string_view name, FontType type) {
   }
 
 const Texture2d *Resources::loadTexture(std::string_view name) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
-  return inst->implLoadTexture(inst->texCache,name);
+  if(name.empty())
+    return nullptr;
+  inst->record(MfTexture,name);
+  return inst->texCache.get(name,[name](){
+    return inst->implLoadTexture(name);
+    },isPinning());
   }
 
 const Texture2d *Resources::loadTexture(std::string_view name, int32_t iv, int32_t ic) {
@@ -602,6 +1097,45 @@ const Texture2d *Resources::loadTexture(std::string_view name, int32_t iv, int32
   return loadTexture(buf1);
   }
 
+void Resources::prefetchTexture(std::string_view name) {
+  if(name.empty() || inst->texCache.has(name))
+    return;
+  inst->implLoadAsync(inst->asyncTexture,name,[](const std::string& n) -> std::shared_ptr<Pixmap> {
+    if(!inst->claimTexture(n))
+      return nullptr;
+    auto pm = inst->implDecodeTexture(n);
+    std::lock_guard<std::mutex> g(inst->asyncSync);
+    inst->asyncTexClaimed.erase(n);
+    return pm;
+    });
+  }
+
+void Resources::uploadPending() {
+  inst->implUploadPending();
+  }
+
+static bool animFrameName(char* buf, size_t bufSz, std::string_view name, int id) {
+  size_t at = 0;
+  for(size_t i=0;i<name.size();++i) {
+    if(at+1>=bufSz)
+      return false;
+    if(i+2<name.size() && name[i]=='_' && (name[i+1]=='A' || name[i+1]=='a') && name[i+2]=='0'){
+      int len = std::snprintf(buf+at,bufSz-at,"_A%d",id);
+      if(len<0 || at+size_t(len)>=bufSz)
+        return false;
+      at += size_t(len);
+      i+=2;
+      } else {
+      buf[at] = name[i];
+      if('a'<=buf[at] && buf[at]<='z')
+        buf[at] = char(buf[at]+'A'-'a');
+      at++;
+      }
+    }
+  buf[at] = '\0';
+  return true;
+  }
+
 std::vector<const Texture2d*> Resources::loadTextureAnim(std::string_view name) {
   std::vector<const Texture2d*> ret;
   if(name.find("_A0")==std::string::npos &&
@@ -609,22 +1143,15 @@ std::vector<const Texture2d*> Resources::loadTextureAnim(std::string_view name)
     return ret;
 
   for(int id=0; ; ++id) {
-    size_t at = 0;
-    char   buf[128]={};
-    for(size_t i=0;i<name.size();++i) {
-      if(i+2<name.size() && name[i]=='_' && (name[i+1]=='A' || name[i+1]=='a') && name[i+2]=='0'){
-        at += size_t(std::snprintf(buf+at,sizeof(buf)-at,"_A%d",id));
-        i+=2;
-        } else {
-        buf[at] = name[i];
-        if('a'<=buf[at] && buf[at]<='z')
-          buf[at] = char(buf[at]+'A'-'a');
-        at++;
-        }
-      if(at>sizeof(buf))
-        return ret;
-      }
-   auto t = loadTexture(std::string_view(buf));
+    char buf[128]={};
+    if(!animFrameName(buf,sizeof(buf),name,id))
+      return ret;
+    // next frame is decoded in background, while this one is uploaded
+    char next[128]={};
+    if(animFrameName(next,sizeof(next),name,id+1))
+      prefetchTexture(std::string_view(next));
+
+    auto t = loadTexture(std::string_view(buf));
     if(t==nullptr) {
       char buf2[128] = {};
       std::snprintf(buf2,sizeof(buf2),"%s.TGA",buf);
@@ -652,8 +1179,13 @@ Material Resources::loadMaterial(const ZenLoad::zCMaterialData& src, bool enable
 const ProtoMesh* Resources::loadMesh(std::string_view name) {
   if(name.size()==0)
     return nullptr;
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
-  return inst->implLoadMesh(name);
+  inst->record(MfMesh,name);
+  return inst->aniMeshCache.get(name,[name](){
+    auto ret = inst->implLoadMeshMain(std::string(name));
+    if(ret==nullptr)
+      Log::e("unable to load mesh \"",name,"\"");
+    return ret;
+    },isPinning());
   }
 
 const PfxEmitterMesh* Resources::loadEmiterMesh(std::string_view name) {
@@ -671,21 +1203,42 @@ const Skeleton* Resources::loadSkeleton(std::string_view name) {
   }
 
 const Animation* Resources::loadAnimation(std::string_view name) {
-  auto cname = std::string(name);
+  inst->record(MfAnimation,name);
+  return inst->animCache.get(name,[name](){
+    return inst->implLoadAnimation(std::string(name));
+    },isPinning());
+  }
 
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
-  auto& cache = inst->animCache;
-  auto it=cache.find(cname);
-  if(it!=cache.end())
-    return it->second.get();
-  auto t       = inst->implLoadAnimation(cname);
-  auto ret     = t.get();
-  cache[cname] = std::move(t);
-  return ret;
+std::shared_future<const ProtoMesh*> Resources::loadMeshAsync(std::string_view name) {
+  inst->record(MfMesh,name);
+  return inst->implLoadMeshAsync(name);
+  }
+
+std::shared_future<const Skeleton*> Resources::loadSkeletonAsync(std::string_view name) {
+  inst->record(MfMesh,name);
+  return inst->implLoadAsync(inst->asyncSkeleton,name,[](const std::string& n){
+    return Resources::loadSkeleton(n);
+    });
+  }
+
+std::shared_future<const Animation*> Resources::loadAnimationAsync(std::string_view name) {
+  inst->record(MfAnimation,name);
+  return inst->implLoadAnimationAsync(name);
+  }
+
+std::shared_future<const ProtoMesh*> Resources::implLoadMeshAsync(std::string_view name) {
+  return implLoadAsync(asyncMesh,name,[](const std::string& n){
+    return Resources::loadMesh(n);
+    });
+  }
+
+std::shared_future<const Animation*> Resources::implLoadAnimationAsync(std::string_view name) {
+  return implLoadAsync(asyncAnim,name,[](const std::string& n){
+    return Resources::loadAnimation(n);
+    });
   }
 
 Tempest::Sound Resources::loadSoundBuffer(std::string_view name) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
   return inst->implLoadSoundBuffer(name);
   }
 
@@ -12,10 +12,20 @@
 #include <zenload/zTypes.h>
 
 #include <tuple>
+#include <atomic>
+#include <unordered_set>
 #include <string_view>
+#include <future>
+#include <thread>
+#include <deque>
+#include <functional>
+#include <condition_variable>
 
 #include "graphics/material.h"
 #include "sound/soundfx.h"
+#include "utils/concurrentcache.h"
+#include "utils/diskcache.h"
+#include "utils/mappedarchive.h"
 
 class StaticMesh;
 class ProtoMesh;
@@ -95,6 +105,9 @@ class Resources final {
     static const Tempest::Texture2d* loadTexture(std::string_view name, int32_t v, int32_t c);
     static       Tempest::Texture2d  loadTexturePm(const Tempest::Pixmap& pm);
     static auto                      loadTextureAnim(std::string_view name) -> std::vector<const Tempest::Texture2d*>;
+    // decodes texture in background; result is uploaded by uploadPending or on first request
+    static void                      prefetchTexture(std::string_view name);
+    static void                      uploadPending();
     static       Material            loadMaterial(const ZenLoad::zCMaterialData& src, bool enableAlphaTest);
 
     static const AttachBinder*       bindMesh       (const ProtoMesh& anim, const Skeleton& s);
@@ -104,6 +117,11 @@ class Resources final {
     static const Animation*          loadAnimation  (std::string_view name);
     static Tempest::Sound            loadSoundBuffer(std::string_view name);
 
+    // background loading: future is shared by all requests with same name
+    static auto                      loadMeshAsync     (std::string_view name) -> std::shared_future<const ProtoMesh*>;
+    static auto                      loadSkeletonAsync (std::string_view name) -> std::shared_future<const Skeleton*>;
+    static auto                      loadAnimationAsync(std::string_view name) -> std::shared_future<const Animation*>;
+
     static Dx8::PatternList          loadDxMusic(std::string_view name);
     static const ProtoMesh*          decalMesh(const ZenLoad::zCVobData& vob);
 
@@ -119,10 +137,35 @@ class Resources final {
 
     static std::vector<uint8_t>      getFileData(std::string_view name);
     static bool                      getFileData(std::string_view name, std::vector<uint8_t>& dat);
+    // zero-copy access to archive content; empty, if file is not mapped
+    static MappedArchive::View       getFileView(std::string_view name);
     static bool                      hasFile    (std::string_view fname);
 
     static VDFS::FileIndex&          vdfsIndex();
 
+    // baked world data: invalidated together with game archives
+    static bool                      readBaked (std::string_view world, std::string_view tag, std::vector<uint8_t>& out);
+    static void                      writeBaked(std::string_view world, std::string_view tag, const std::vector<uint8_t>& data);
+    // speculative: static data and assets of world, that is likely to be loaded next
+    static void                      preloadWorld (std::string_view zen);
+    // empty name cancels any preload
+    static void                      cancelPreload(std::string_view zen);
+
+    // assets, loaded within scope, are held by global definitions or UI and never evicted
+    class PinScope final {
+      public:
+        PinScope();
+        ~PinScope();
+        PinScope(const PinScope&)=delete;
+      };
+
+    static void                      beginWorldLoad();
+    static void                      evictUnused();
+
+    // per-world list of requested assets: replayed as background prefetch on next load of same world
+    static void                      beginManifest(std::string_view world);
+    static void                      endManifest  (std::string_view world);
+
     static const Tempest::VertexBuffer<VertexFsq>& fsqVbo();
 
   private:
@@ -148,14 +191,18 @@ class Resources final {
         }
       };
 
-    using TextureCache = std::unordered_map<std::string,std::unique_ptr<Tempest::Texture2d>>;
+    template<class T>
+    using AsyncCache   = std::unordered_map<std::string,std::shared_future<T>>;
 
     int64_t               vdfTimestamp(const std::u16string& name);
     void                  detectVdf(std::vector<Archive>& ret, const std::u16string& root);
+    static uint64_t       fingerprint(const std::vector<Archive>& archives);
 
-    Tempest::Texture2d*   implLoadTexture(TextureCache& cache, std::string_view cname);
-    Tempest::Texture2d*   implLoadTexture(TextureCache& cache, std::string &&name, const std::vector<uint8_t> &data);
-    ProtoMesh*            implLoadMesh(std::string_view name);
+    std::unique_ptr<Tempest::Texture2d> implLoadTexture(std::string_view cname);
+    std::shared_ptr<Tempest::Pixmap>    implDecodeTexture(std::string_view cname);
+    std::shared_ptr<Tempest::Pixmap>    implDecodeTexture(const uint8_t* data, size_t size);
+    bool                                claimTexture(const std::string& name);
+    void                                implUploadPending();
     std::unique_ptr<ProtoMesh> implLoadMeshMain(std::string name);
     std::unique_ptr<Animation> implLoadAnimation(std::string name);
     ProtoMesh*            implDecalMesh(const ZenLoad::zCVobData& vob);
@@ -165,6 +212,26 @@ class Resources final {
     PfxEmitterMesh*       implLoadEmiterMesh(std::string_view name);
     ZenLoad::oCWorldData& implLoadVobBundle(std::string_view name);
 
+    template<class T, class F>
+    std::shared_future<T> implLoadAsync(AsyncCache<T>& cache, std::string_view name, F load);
+    auto                  implLoadMeshAsync     (std::string_view name) -> std::shared_future<const ProtoMesh*>;
+    auto                  implLoadAnimationAsync(std::string_view name) -> std::shared_future<const Animation*>;
+    template<class T>
+    void                  dropAsync(AsyncCache<T>& cache, const std::vector<const void*>& evicted);
+    void                  implEvictUnused();
+    void                  implDrainAsync();
+    void                  implBeginManifest(std::string_view world);
+    void                  implEndManifest  (std::string_view world);
+    void                  implPrefetchManifest(std::string_view world);
+    void                  implPreloadWorld(std::string_view zen);
+    void                  record(char type, std::string_view name);
+    static std::string    manifestPath(std::string_view world);
+    // world name without path, lowercase: both change-world and startup loads map to same key
+    static std::string    worldKey(std::string_view zen);
+    static std::string    bakedKey(std::string_view world, std::string_view tag);
+    static bool           isPinning();
+    void                  asyncThreadFunc();
+
     Tempest::VertexBuffer<Vertex> sphere(int passCount, float R);
 
     Tempest::Texture2d fallback, fbZero;
@@ -191,18 +258,46 @@ class Resources final {
     std::recursive_mutex              sync;
     std::unique_ptr<Dx8::DirectMusic> dxMusic;
     VDFS::FileIndex                   gothicAssets;
+    MappedArchive                     mappedAssets;
+    std::unique_ptr<DiskCache>        texDiskCache;
+    std::unique_ptr<DiskCache>        worldDiskCache;
 
-    std::vector<uint8_t>              fBuff, ddsBuf;
     Tempest::VertexBuffer<VertexFsq>  fsq;
 
-    TextureCache                                                          texCache;
+    // no global lock: can be loaded from many threads at once
+    ConcurrentCache<Tempest::Texture2d>                                   texCache;
+    ConcurrentCache<ProtoMesh>                                            aniMeshCache;
+    ConcurrentCache<Animation>                                            animCache;
+
+    // LRU eviction: epoch is advanced for every world load
+    uint32_t                                                              cacheEpoch   = 0;
+    bool                                                                  evictPending = false;
+    size_t                                                                gpuBudget    = 0;
+    size_t                                                                cpuBudget    = 0;
 
-    std::unordered_map<std::string,std::unique_ptr<ProtoMesh>>            aniMeshCache;
     std::unordered_map<DecalK,std::unique_ptr<ProtoMesh>,Hash>            decalMeshCache;
-    std::unordered_map<std::string,std::unique_ptr<Skeleton>>             skeletonCache;
-    std::unordered_map<std::string,std::unique_ptr<Animation>>            animCache;
     std::unordered_map<BindK,std::unique_ptr<AttachBinder>,Hash>          bindCache;
     std::unordered_map<std::string,std::unique_ptr<PfxEmitterMesh>>       emiMeshCache;
     std::unordered_map<FontK,std::unique_ptr<GthFont>,Hash>               gothicFnt;
     std::unordered_map<std::string,ZenLoad::oCWorldData>                  zenCache;
+
+    std::mutex                                                            asyncSync;
+    std::condition_variable                                               asyncWait;
+    std::condition_variable                                               asyncIdle;
+    uint32_t                                                              asyncBusy = 0;
+    std::deque<std::function<void()>>                                     asyncQueue;
+    bool                                                                  asyncRunning = true;
+    AsyncCache<const ProtoMesh*>                                          asyncMesh;
+    AsyncCache<const Skeleton*>                                           asyncSkeleton;
+    AsyncCache<const Animation*>                                          asyncAnim;
+    AsyncCache<std::shared_ptr<Tempest::Pixmap>>                          asyncTexture;
+    std::unordered_set<std::string>                                       asyncTexClaimed;
+    std::string                                                           preloadName;
+    std::unordered_map<std::string,std::vector<uint8_t>>                  preloadBaked;
+    std::vector<std::thread>                                              asyncTh;
+
+    std::mutex                                                            manifestSync;
+    std::atomic_bool                                                      manifestRec{false};
+    std::string                                                           manifestWorld;
+    std::unordered_set<std::string>                                       manifest;
   };
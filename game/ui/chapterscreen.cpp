@@ -13,6 +13,7 @@ ChapterScreen::ChapterScreen() {
   }
 
 void ChapterScreen::show(const Show& s) {
+  Resources::PinScope pin;
   back = Resources::loadTexture(s.img);
   if(!active)
     Gothic::inst().pushPause();
@@ -60,6 +60,7 @@ ConsoleWidget::ConsoleWidget() {
   closeSk = Shortcut(*this,Event::M_NoModifier,Event::K_F2);
   closeSk.onActivated.bind(this,&ConsoleWidget::close);
 
+  Resources::PinScope pin;
   background = Resources::loadTexture("CONSOLE.TGA");
 
   marvin.print.bind(this,&ConsoleWidget::printLine);
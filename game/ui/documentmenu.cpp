@@ -10,6 +10,7 @@ using namespace Tempest;
 
 DocumentMenu::DocumentMenu(const KeyCodec& key)
   :keycodec(key) {
+  Resources::PinScope pin;
   cursor = Resources::loadTexture("U.TGA");
   }
 
@@ -48,6 +49,7 @@ void DocumentMenu::paintEvent(PaintEvent &e) {
   if(!active)
     return;
 
+  Resources::PinScope pin;
   float mw = 0, mh = 0;
   for(auto& i:document.pages){
     auto back = Resources::loadTexture((i.flg&F_Backgr) ? i.img : document.img);
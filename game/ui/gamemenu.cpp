@@ -96,6 +96,7 @@ struct GameMenu::SavNameDialog : Dialog {
 
 GameMenu::GameMenu(MenuRoot &owner, KeyCodec& keyCodec, Daedalus::DaedalusVM &vm, const char* menuSection, KeyCodec::Action kClose)
   :owner(owner), keyCodec(keyCodec), vm(vm), kClose(kClose) {
+  Resources::PinScope pin;
   timer.timeout.bind(this,&GameMenu::onTick);
   timer.start(100);
 
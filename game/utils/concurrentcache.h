@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// named resource cache: hit takes shared lock of a single shard and doesn't allocate,
+// miss loads every key only once, different keys can load in parallel; names are case-insensitive
+template<class T>
+class ConcurrentCache final {
+  public:
+    using SizeOf = size_t(*)(const T&);
+
+    explicit ConcurrentCache(SizeOf sizeOf = nullptr):sizeOf(sizeOf) {}
+    ConcurrentCache(const ConcurrentCache&) = delete;
+
+    // requests are stamped with current epoch, for LRU eviction; pinned entries are never evicted
+    template<class F>
+    T* get(std::string_view name, F load, bool pin = false) {
+      Entry* e = entry(name,pin);
+      if(!e->ready.load(std::memory_order_acquire)) {
+        std::call_once(e->once,[this,e,&load]() {
+          e->value = load();
+          e->bytes = (e->value!=nullptr && sizeOf!=nullptr) ? sizeOf(*e->value) : 0;
+          e->ready.store(true,std::memory_order_release);
+          });
+        }
+      return e->value.get();
+      }
+
+    // lookup only: doesn't create entry and doesn't touch it
+    bool has(std::string_view name) {
+      auto& s = shardOf(name);
+      std::shared_lock<std::shared_mutex> g(s.sync);
+      return s.data.find(name)!=s.data.end();
+      }
+
+    void     setEpoch(uint32_t e) { epoch.store(e); }
+
+    size_t memoryUsage() {
+      size_t ret = 0;
+      for(auto& s:shard) {
+        std::shared_lock<std::shared_mutex> g(s.sync);
+        for(auto& i:s.data)
+          if(i.second->ready.load(std::memory_order_acquire))
+            ret += i.second->bytes;
+        }
+      return ret;
+      }
+
+    template<class F>
+    void forEach(F fn) {
+      for(auto& s:shard) {
+        std::shared_lock<std::shared_mutex> g(s.sync);
+        for(auto& i:s.data)
+          if(i.second->ready.load(std::memory_order_acquire) && i.second->value!=nullptr)
+            fn(*i.second->value);
+        }
+      }
+
+    // drops least recently used entries, not requested since `keepSince`, until usage fits into budget
+    template<class R>
+    size_t evict(uint32_t keepSince, size_t budget, R isReferenced, std::vector<std::unique_ptr<T>>& out) {
+      struct Candidate {
+        uint32_t    lastUse = 0;
+        size_t      bytes   = 0;
+        Shard*      shard   = nullptr;
+        std::string key;
+        };
+      std::vector<Candidate> cand;
+      size_t                 total = 0;
+
+      for(auto& s:shard) {
+        std::shared_lock<std::shared_mutex> g(s.sync);
+        for(auto& i:s.data) {
+          auto& e = *i.second;
+          if(!e.ready.load(std::memory_order_acquire))
+            continue;
+          total += e.bytes;
+          if(e.pinned.load() || e.value==nullptr || e.lastUse.load()>=keepSince || isReferenced(e.value.get()))
+            continue;
+          cand.push_back(Candidate{e.lastUse.load(),e.bytes,&s,e.name});
+          }
+        }
+
+      if(total<=budget)
+        return total;
+      std::sort(cand.begin(),cand.end(),[](const Candidate& l, const Candidate& r){
+        return l.lastUse<r.lastUse;
+        });
+
+      for(auto& c:cand) {
+        if(total<=budget)
+          break;
+        std::unique_lock<std::shared_mutex> g(c.shard->sync);
+        auto it = c.shard->data.find(c.key);
+        // re-check: entry might be requested in between
+        if(it==c.shard->data.end() || it->second->lastUse.load()>=keepSince)
+          continue;
+        out.emplace_back(std::move(it->second->value));
+        c.shard->data.erase(it);
+        total -= c.bytes;
+        }
+      return total;
+      }
+
+  private:
+    enum { ShardCount = 16 };
+
+    struct Entry final {
+      std::string           name; // storage for map key
+      std::once_flag        once;
+      std::atomic_bool      ready{false};
+      std::atomic_bool      pinned{false};
+      std::atomic<uint32_t> lastUse{0};
+      size_t                bytes = 0;
+      std::unique_ptr<T>    value;
+      };
+
+    static char upper(char c) {
+      if('a'<=c && c<='z')
+        return char((c-'a')+'A');
+      return c;
+      }
+
+    static uint64_t hashKey(std::string_view name) {
+      uint64_t h = 0xcbf29ce484222325ull;
+      for(auto c:name) {
+        h ^= uint8_t(upper(c));
+        h *= 0x100000001b3ull;
+        }
+      return h;
+      }
+
+    struct KeyHash final {
+      size_t operator()(std::string_view name) const { return size_t(hashKey(name)); }
+      };
+
+    struct KeyEqual final {
+      bool operator()(std::string_view a, std::string_view b) const {
+        if(a.size()!=b.size())
+          return false;
+        for(size_t i=0; i<a.size(); ++i)
+          if(upper(a[i])!=upper(b[i]))
+            return false;
+        return true;
+        }
+      };
+
+    struct Shard final {
+      std::shared_mutex                                                          sync;
+      std::unordered_map<std::string_view,std::unique_ptr<Entry>,KeyHash,KeyEqual> data;
+      };
+
+    Shard& shardOf(std::string_view name) {
+      // high bits: low ones are used for buckets within shard
+      return shard[(hashKey(name)>>32)%ShardCount];
+      }
+
+    static void touch(Entry& e, uint32_t ep, bool pin) {
+      if(e.lastUse.load(std::memory_order_relaxed)!=ep)
+        e.lastUse.store(ep,std::memory_order_relaxed);
+      if(pin && !e.pinned.load(std::memory_order_relaxed))
+        e.pinned.store(true);
+      }
+
+    Entry* entry(std::string_view name, bool pin) {
+      auto&          s  = shardOf(name);
+      const uint32_t ep = epoch.load(std::memory_order_relaxed);
+      {
+      std::shared_lock<std::shared_mutex> g(s.sync);
+      auto it = s.data.find(name);
+      if(it!=s.data.end()) {
+        touch(*it->second,ep,pin);
+        return it->second.get();
+        }
+      }
+      std::unique_lock<std::shared_mutex> g(s.sync);
+      auto it = s.data.find(name);
+      if(it==s.data.end()) {
+        std::unique_ptr<Entry> e(new Entry());
+        e->name = std::string(name);
+        std::string_view key = e->name;
+        it = s.data.emplace(key,std::move(e)).first;
+        }
+      touch(*it->second,ep,pin);
+      return it->second.get();
+      }
+
+    SizeOf                sizeOf = nullptr;
+    std::atomic<uint32_t> epoch{0};
+    Shard                 shard[ShardCount];
+  };
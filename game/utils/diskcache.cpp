@@ -0,0 +1,184 @@
+#include "diskcache.h"
+
+#include <Tempest/Log>
+#include <cstdio>
+#include <cstring>
+
+using namespace Tempest;
+
+static const char magic[8] = {'O','G','C','A','C','H','E','\0'};
+
+DiskCache::DiskCache(std::string p, uint64_t fingerprint)
+  :path(std::move(p)) {
+  if(!implOpen(fingerprint)) {
+    implReset(fingerprint);
+    return;
+    }
+  if(stale>0 && !implCompact(fingerprint))
+    implReset(fingerprint);
+  }
+
+bool DiskCache::read(std::string_view name, std::vector<uint8_t>& out) {
+  std::lock_guard<std::mutex> g(sync);
+  if(!valid)
+    return false;
+  auto it = index.find(std::string(name));
+  if(it==index.end())
+    return false;
+
+  out.resize(size_t(it->second.size));
+  file.seekg(std::streamoff(it->second.offset));
+  if(!file.read(reinterpret_cast<char*>(out.data()),std::streamsize(out.size()))) {
+    file.clear();
+    return false;
+    }
+  return true;
+  }
+
+void DiskCache::write(std::string_view name, const std::vector<uint8_t>& data) {
+  static const char zero[Alignment] = {};
+
+  std::lock_guard<std::mutex> g(sync);
+  if(!valid || data.empty())
+    return;
+  auto key = std::string(name);
+
+  EntryHeader e = {};
+  e.nameLen = uint32_t(name.size());
+  e.size    = data.size();
+
+  const uint64_t nameEnd = end+sizeof(e)+e.nameLen;
+  const uint64_t dataOff = align(nameEnd);
+  const uint64_t next    = align(dataOff+e.size);
+
+  file.seekp(std::streamoff(end));
+  file.write(reinterpret_cast<const char*>(&e),sizeof(e));
+  file.write(name.data(),std::streamsize(name.size()));
+  file.write(zero,std::streamsize(dataOff-nameEnd));
+  file.write(reinterpret_cast<const char*>(data.data()),std::streamsize(data.size()));
+  file.write(zero,std::streamsize(next-(dataOff+e.size)));
+  file.flush();
+  if(!file) {
+    Log::e("unable to write asset cache: \"",path,"\"");
+    valid = false;
+    return;
+    }
+
+  auto& it = index[std::move(key)];
+  if(it.size>0)
+    stale += align(it.offset+it.size)-it.begin;
+  it  = Item{end,dataOff,e.size};
+  end = next;
+  }
+
+std::vector<std::string> DiskCache::keys(std::string_view prefix) {
+  std::vector<std::string> ret;
+  std::lock_guard<std::mutex> g(sync);
+  for(auto& i:index)
+    if(std::string_view(i.first).substr(0,prefix.size())==prefix)
+      ret.push_back(i.first);
+  return ret;
+  }
+
+bool DiskCache::implOpen(uint64_t fingerprint) {
+  file.open(path,std::ios::in|std::ios::out|std::ios::binary);
+  if(!file.is_open())
+    return false;
+
+  file.seekg(0,std::ios::end);
+  const uint64_t fileSize = uint64_t(file.tellg());
+  file.seekg(0,std::ios::beg);
+
+  Header hdr = {};
+  if(!file.read(reinterpret_cast<char*>(&hdr),sizeof(hdr)))
+    return false;
+  if(std::memcmp(hdr.magic,magic,sizeof(magic))!=0 || hdr.version!=Version || hdr.fingerprint!=fingerprint)
+    return false;
+
+  end = sizeof(Header);
+  std::string name;
+  while(true) {
+    EntryHeader e = {};
+    if(!file.read(reinterpret_cast<char*>(&e),sizeof(e)) || e.nameLen>fileSize)
+      break;
+    const uint64_t dataOff = align(end+sizeof(e)+e.nameLen);
+    // tail of interrupted write - overwritten by next entry
+    if(dataOff+e.size>fileSize)
+      break;
+    name.resize(e.nameLen);
+    if(!file.read(&name[0],std::streamsize(e.nameLen)))
+      break;
+    auto& it = index[name];
+    if(it.size>0)
+      stale += align(it.offset+it.size)-it.begin;
+    it  = Item{end,dataOff,e.size};
+    end = align(dataOff+e.size);
+    file.seekg(std::streamoff(end));
+    }
+  file.clear();
+  valid = true;
+  return true;
+  }
+
+bool DiskCache::implCompact(uint64_t fingerprint) {
+  // copy live entries into new file and replace old one with it
+  const std::string tmp = path+".tmp";
+  std::ofstream     fout(tmp,std::ios::binary|std::ios::trunc);
+  if(!fout.is_open())
+    return false;
+
+  Header hdr = {};
+  std::memcpy(hdr.magic,magic,sizeof(magic));
+  hdr.version     = Version;
+  hdr.fingerprint = fingerprint;
+  fout.write(reinterpret_cast<const char*>(&hdr),sizeof(hdr));
+
+  std::vector<char> buf;
+  for(auto& i:index) {
+    const uint64_t span = align(i.second.offset+i.second.size)-i.second.begin;
+    buf.resize(size_t(span));
+    file.seekg(std::streamoff(i.second.begin));
+    if(!file.read(buf.data(),std::streamsize(buf.size())))
+      break;
+    fout.write(buf.data(),std::streamsize(buf.size()));
+    }
+  const bool ok = bool(file) && bool(fout);
+  fout.close();
+  file.close();
+  file.clear();
+  index.clear();
+  stale = 0;
+  valid = false;
+
+  if(!ok || std::remove(path.c_str())!=0 || std::rename(tmp.c_str(),path.c_str())!=0) {
+    std::remove(tmp.c_str());
+    return false;
+    }
+  return implOpen(fingerprint);
+  }
+
+void DiskCache::implReset(uint64_t fingerprint) {
+  index.clear();
+  stale = 0;
+  valid = false;
+  file.close();
+  file.clear();
+  file.open(path,std::ios::in|std::ios::out|std::ios::binary|std::ios::trunc);
+  if(!file.is_open()) {
+    Log::e("unable to create asset cache: \"",path,"\"");
+    return;
+    }
+
+  Header hdr = {};
+  std::memcpy(hdr.magic,magic,sizeof(magic));
+  hdr.version     = Version;
+  hdr.fingerprint = fingerprint;
+  file.write(reinterpret_cast<const char*>(&hdr),sizeof(hdr));
+  file.flush();
+  if(!file) {
+    Log::e("unable to create asset cache: \"",path,"\"");
+    return;
+    }
+  end   = sizeof(Header);
+  valid = true;
+  }
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// persistent storage of converted assets: single append-only file, payload is 16-byte aligned;
+// whole content is dropped, if fingerprint of game data doesn't match.
+// write of existing key appends new entry, that shadows old one; stale entries are compacted on open
+class DiskCache final {
+  public:
+    DiskCache(std::string path, uint64_t fingerprint);
+    DiskCache(const DiskCache&)=delete;
+
+    bool read (std::string_view name, std::vector<uint8_t>& out);
+    void write(std::string_view name, const std::vector<uint8_t>& data);
+    auto keys (std::string_view prefix) -> std::vector<std::string>;
+
+  private:
+    enum {
+      Alignment = 16,
+      Version   = 1,
+      };
+
+    struct Header final {
+      char     magic[8];
+      uint32_t version;
+      uint32_t padd0;
+      uint64_t fingerprint;
+      uint64_t padd1;
+      };
+
+    struct EntryHeader final {
+      uint32_t nameLen;
+      uint32_t padd0;
+      uint64_t size;
+      };
+
+    struct Item final {
+      uint64_t begin  = 0;
+      uint64_t offset = 0;
+      uint64_t size   = 0;
+      };
+
+    bool            implOpen   (uint64_t fingerprint);
+    void            implReset  (uint64_t fingerprint);
+    bool            implCompact(uint64_t fingerprint);
+    static uint64_t align(uint64_t v) { return (v+Alignment-1)/Alignment*Alignment; }
+
+    std::mutex                           sync;
+    std::string                          path;
+    std::fstream                         file;
+    std::unordered_map<std::string,Item> index;
+    uint64_t                             end   = 0;
+    uint64_t                             stale = 0;
+    bool                                 valid = false;
+  };
@@ -7,6 +7,7 @@ using namespace Tempest;
 
 GthFont::GthFont(const char *name, std::string_view ftex, const Color &cl, const VDFS::FileIndex &fileIndex)
   :fnt(name,fileIndex), color(cl) {
+  Resources::PinScope pin;
   tex = Resources::loadTexture(ftex);
   }
 
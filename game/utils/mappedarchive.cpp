@@ -0,0 +1,188 @@
+#include "mappedarchive.h"
+
+#include <Tempest/Platform>
+#include <Tempest/TextCodec>
+#include <Tempest/Log>
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef __WINDOWS__
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace Tempest;
+
+namespace {
+
+enum : uint32_t {
+  VDF_COMMENT_LENGTH   = 256,
+  VDF_SIGNATURE_LENGTH = 16,
+  VDF_ENTRY_NAME       = 64,
+  VDF_ENTRY_DIR        = 0x80000000,
+  };
+
+#pragma pack(push,1)
+struct VdfHeader {
+  char     comment  [VDF_COMMENT_LENGTH];
+  char     signature[VDF_SIGNATURE_LENGTH];
+  uint32_t numEntries;
+  uint32_t numFiles;
+  uint32_t timestamp;
+  uint32_t dataSize;
+  uint32_t catalogOffset;
+  uint32_t version;
+  };
+
+struct VdfEntry {
+  char     name[VDF_ENTRY_NAME];
+  uint32_t offset;
+  uint32_t size;
+  uint32_t type;
+  uint32_t attributes;
+  };
+#pragma pack(pop)
+
+}
+
+static char upper(char c) {
+  if('a'<=c && c<='z')
+    return char((c-'a')+'A');
+  return c;
+  }
+
+static int compareNoCase(std::string_view a, std::string_view b) {
+  const size_t n = std::min(a.size(),b.size());
+  for(size_t i=0; i<n; ++i) {
+    const char ca = upper(a[i]);
+    const char cb = upper(b[i]);
+    if(ca!=cb)
+      return ca<cb ? -1 : 1;
+    }
+  if(a.size()==b.size())
+    return 0;
+  return a.size()<b.size() ? -1 : 1;
+  }
+
+MappedArchive::Mapping::~Mapping() {
+#ifdef __WINDOWS__
+  if(data!=nullptr)
+    UnmapViewOfFile(data);
+  if(mapping!=nullptr)
+    CloseHandle(mapping);
+  if(file!=nullptr)
+    CloseHandle(file);
+#else
+  if(data!=nullptr)
+    munmap(const_cast<uint8_t*>(data),size);
+#endif
+  }
+
+bool MappedArchive::mapFile(const std::u16string& path, Mapping& m) {
+#ifdef __WINDOWS__
+  HANDLE f = CreateFileW(reinterpret_cast<const WCHAR*>(path.c_str()),GENERIC_READ,FILE_SHARE_READ,nullptr,
+                         OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,nullptr);
+  if(f==INVALID_HANDLE_VALUE)
+    return false;
+  m.file = f;
+
+  LARGE_INTEGER sz = {};
+  if(!GetFileSizeEx(f,&sz) || sz.QuadPart<=0)
+    return false;
+  m.mapping = CreateFileMappingW(f,nullptr,PAGE_READONLY,0,0,nullptr);
+  if(m.mapping==nullptr)
+    return false;
+  m.data = reinterpret_cast<const uint8_t*>(MapViewOfFile(m.mapping,FILE_MAP_READ,0,0,0));
+  m.size = size_t(sz.QuadPart);
+  return m.data!=nullptr;
+#else
+  std::string p  = TextCodec::toUtf8(path);
+  int         fd = open(p.c_str(),O_RDONLY);
+  if(fd<0)
+    return false;
+  struct stat st = {};
+  if(fstat(fd,&st)!=0 || st.st_size<=0) {
+    close(fd);
+    return false;
+    }
+  void* ptr = mmap(nullptr,size_t(st.st_size),PROT_READ,MAP_PRIVATE,fd,0);
+  close(fd);
+  if(ptr==MAP_FAILED)
+    return false;
+  m.data = reinterpret_cast<const uint8_t*>(ptr);
+  m.size = size_t(st.st_size);
+  return true;
+#endif
+  }
+
+bool MappedArchive::load(const std::u16string& path) {
+  auto m = std::make_unique<Mapping>();
+  if(!mapFile(path,*m)) {
+    Log::e("unable to map archive: \"",TextCodec::toUtf8(path),"\"");
+    return false;
+    }
+  if(m->size<sizeof(VdfHeader))
+    return false;
+
+  VdfHeader hdr = {};
+  std::memcpy(&hdr,m->data,sizeof(hdr));
+  if(std::memcmp(hdr.signature,"PSVDSC_V2.00",12)!=0)
+    return false;
+  if(uint64_t(hdr.catalogOffset)+uint64_t(hdr.numEntries)*sizeof(VdfEntry)>m->size)
+    return false;
+
+  const uint32_t order = uint32_t(maps.size());
+  for(uint32_t i=0; i<hdr.numEntries; ++i) {
+    VdfEntry e = {};
+    std::memcpy(&e,m->data+hdr.catalogOffset+i*sizeof(VdfEntry),sizeof(e));
+    if((e.type & VDF_ENTRY_DIR)!=0)
+      continue;
+    if(uint64_t(e.offset)+e.size>m->size)
+      continue;
+
+    // names are padded with spaces
+    size_t len = VDF_ENTRY_NAME;
+    while(len>0 && (e.name[len-1]==' ' || e.name[len-1]=='\0'))
+      --len;
+
+    Entry ent;
+    ent.name.resize(len);
+    for(size_t r=0; r<len; ++r)
+      ent.name[r] = upper(e.name[r]);
+    ent.view.data = m->data+e.offset;
+    ent.view.size = e.size;
+    ent.order     = order;
+    index.emplace_back(std::move(ent));
+    }
+
+  maps.emplace_back(std::move(m));
+  return true;
+  }
+
+void MappedArchive::finalizeLoad() {
+  std::sort(index.begin(),index.end(),[](const Entry& l, const Entry& r){
+    const int cmp = compareNoCase(l.name,r.name);
+    if(cmp!=0)
+      return cmp<0;
+    return l.order<r.order;
+    });
+  // keep only first occurrence of each name
+  index.erase(std::unique(index.begin(),index.end(),[](const Entry& l, const Entry& r){
+    return l.name==r.name;
+    }),index.end());
+  index.shrink_to_fit();
+  }
+
+MappedArchive::View MappedArchive::find(std::string_view name) const {
+  auto it = std::lower_bound(index.begin(),index.end(),name,[](const Entry& e, std::string_view n){
+    return compareNoCase(e.name,n)<0;
+    });
+  if(it==index.end() || compareNoCase(it->name,name)!=0)
+    return View();
+  return it->view;
+  }
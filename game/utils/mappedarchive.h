@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// read-only memory mapped VDF/MOD archives: entries are stored uncompressed, so content is accessed in place
+class MappedArchive final {
+  public:
+    MappedArchive()=default;
+    MappedArchive(const MappedArchive&)=delete;
+
+    struct View final {
+      const uint8_t* data = nullptr;
+      size_t         size = 0;
+      bool           isEmpty() const { return data==nullptr; }
+      };
+
+    // archives, loaded earlier, have priority for duplicated names
+    bool load(const std::u16string& path);
+    void finalizeLoad();
+
+    View find(std::string_view name) const;
+
+  private:
+    struct Mapping final {
+      ~Mapping();
+      const uint8_t* data    = nullptr;
+      size_t         size    = 0;
+      void*          file    = nullptr;
+      void*          mapping = nullptr;
+      };
+
+    struct Entry final {
+      std::string name;
+      View        view;
+      uint32_t    order = 0;
+      };
+
+    static bool mapFile(const std::u16string& path, Mapping& m);
+
+    std::vector<std::unique_ptr<Mapping>> maps;
+    std::vector<Entry>                    index;
+  };
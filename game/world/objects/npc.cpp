@@ -166,7 +166,7 @@ Npc::Npc(World &owner, size_t instance, std::string_view waypoint)
     return;
 
   hnpc.wp = std::string(waypoint);
-  owner.script().initializeInstance(hnpc,instance);
+  owner.script().initializeNpc(*this,instance);
   if(hnpc.attribute[ATR_HITPOINTS]<=1 && hnpc.attribute[ATR_HITPOINTSMAX]<=1) {
     onNoHealth(true,HS_NoSound);
     }
@@ -730,8 +730,7 @@ void Npc::setVisual(std::string_view visual) {
   }
 
 bool Npc::hasOverlay(std::string_view sk) const {
-  auto skelet = Resources::loadSkeleton(sk);
-  return hasOverlay(skelet);
+  return visual.hasOverlay(sk);
   }
 
 bool Npc::hasOverlay(const Skeleton* sk) const {
@@ -739,8 +738,9 @@ bool Npc::hasOverlay(const Skeleton* sk) const {
   }
 
 void Npc::addOverlay(std::string_view sk, uint64_t time) {
-  auto skelet = Resources::loadSkeleton(sk);
-  addOverlay(skelet,time);
+  if(time!=0)
+    time+=owner.tickCount();
+  visual.addOverlay(sk,time);
   }
 
 void Npc::addOverlay(const Skeleton* sk,uint64_t time) {
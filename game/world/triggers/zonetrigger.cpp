@@ -2,9 +2,34 @@
 
 #include "world/objects/npc.h"
 #include "world/world.h"
+#include "resources.h"
+
+// next world is preloaded in background, once player is that close to the trigger,
+// and dropped again, once player walks away further than cancelDistance
+static const float preloadDistance = 30*100;
+static const float cancelDistance  = 60*100;
 
 ZoneTrigger::ZoneTrigger(Vob* parent, World &world, ZenLoad::zCVobData &&d, bool startup)
   :AbstractTrigger(parent,world,std::move(d),startup){
+  enableTicks();
+  }
+
+void ZoneTrigger::tick(uint64_t) {
+  auto pl = world.player();
+  if(pl==nullptr)
+    return;
+  const float dist = (pl->position()-position()).quadLength();
+  if(preloaded) {
+    if(dist>cancelDistance*cancelDistance) {
+      preloaded = false;
+      Resources::cancelPreload(data.oCTriggerChangeLevel.levelName);
+      }
+    return;
+    }
+  if(dist>preloadDistance*preloadDistance)
+    return;
+  preloaded = true;
+  Resources::preloadWorld(data.oCTriggerChangeLevel.levelName);
   }
 
 void ZoneTrigger::onIntersect(Npc &n) {
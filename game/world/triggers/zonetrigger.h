@@ -7,4 +7,8 @@ class ZoneTrigger : public AbstractTrigger {
     ZoneTrigger(Vob* parent, World& world, ZenLoad::zCVobData&& data, bool startup);
 
     void onIntersect(Npc& n) override;
+    void tick(uint64_t dt) override;
+
+  private:
+    bool preloaded = false;
   };
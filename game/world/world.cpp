@@ -4,6 +4,8 @@
 #include <fstream>
 #include <functional>
 #include <cctype>
+#include <exception>
+#include <thread>
 
 #include <Tempest/Log>
 #include <Tempest/Painter>
@@ -21,6 +23,9 @@
 #include "focus.h"
 #include "resources.h"
 
+// assets, requested within this time after world load, are stored in prefetch manifest
+static const uint64_t ManifestRecordTime = 10000;
+
 const char* materialTag(ItemMaterial src) {
   switch(src) {
     case ItemMaterial::MAT_WOOD:
@@ -64,6 +69,8 @@ World::World(GameSession& game, std::string file, bool startup, std::function<vo
   :wname(std::move(file)),game(game),wsound(game,*this),wobj(*this) {
   using namespace Daedalus::GameState;
 
+  // assets of previous session are loaded in background, while zen is parsed
+  Resources::beginManifest(wname);
   ZenLoad::ZenParser parser(wname,Resources::vdfsIndex());
 
   loadProgress(1);
@@ -78,16 +85,36 @@ World::World(GameSession& game, std::string file, bool startup, std::function<vo
   parser.readWorld(world,fver);
 
   ZenLoad::zCMesh* worldMesh = parser.getWorldMesh();
-  PackedMesh vmesh(*worldMesh,PackedMesh::PK_VisualLnd);
 
-  loadProgress(50);
-  wdynamic.reset(new DynamicWorld(*this,*worldMesh));
-  wview.reset   (new WorldView(*this,vmesh));
+  // physics, render mesh and waynet are independent: physics goes to separate thread,
+  // vobs are created after all of them, since they register in view and physics
+  std::exception_ptr physicErr;
+  std::thread        physicTh([this,worldMesh,&physicErr]() noexcept {
+    try {
+      wdynamic.reset(new DynamicWorld(*this,*worldMesh));
+      }
+    catch(...) {
+      physicErr = std::current_exception();
+      }
+    });
+
+  try {
+    wmatrix.reset(new WayMatrix(*this,world.waynet));
+    PackedMesh vmesh = PackedMesh::baked(wname,*worldMesh,PackedMesh::PK_VisualLnd);
+    loadProgress(50);
+    wview.reset(new WorldView(*this,vmesh));
+    }
+  catch(...) {
+    physicTh.join();
+    throw;
+    }
+  physicTh.join();
+  if(physicErr)
+    std::rethrow_exception(physicErr);
   loadProgress(70);
 
   globFx.reset(new GlobalEffects(*this));
 
-  wmatrix.reset(new WayMatrix(*this,world.waynet));
   if(1){
     for(auto& vob:world.rootVobs)
       wobj.addRoot(std::move(vob),startup);
@@ -99,6 +126,7 @@ World::World(GameSession& game, std::string file, bool startup, std::function<vo
   }
 
 World::~World() {
+  Resources::endManifest(wname);
   }
 
 void World::createPlayer(std::string_view cls) {
@@ -329,6 +357,12 @@ void World::tick(uint64_t dt) {
   if(auto pl = player())
     wsound.tick(*pl);
   globFx->tick(dt);
+
+  if(manifestTime<ManifestRecordTime) {
+    manifestTime += dt;
+    if(manifestTime>=ManifestRecordTime)
+      Resources::endManifest(wname);
+    }
   }
 
 uint64_t World::tickCount() const {
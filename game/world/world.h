@@ -194,6 +194,7 @@ class World final {
     WorldSound                            wsound;
     WorldObjects                          wobj;
     std::unique_ptr<Npc>                  lvlInspector;
+    uint64_t                              manifestTime = 0;
 
     auto         roomAt(const ZenLoad::zCBspNode &node) -> const std::string &;
     auto         portalAt(std::string_view tag) -> BspSector*;